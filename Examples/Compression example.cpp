@@ -0,0 +1,31 @@
+#include "LibFileStream.hpp"
+#include <iostream>
+
+//Writes, appends and reads back gzip compressed file with block index. Compile with -DLIBFILESTREAM_USE_ZLIB and link with -lz.
+int main()
+{
+    std::vector<char> first(1000, 'a'), second(1000, 'b');
+    fileCompression compression;
+    compression.blockSize = 256;
+    compression.index = true;
+    fileStream<char> stream("compressed.gz", 2, true, compression);
+    if(stream.error != 0) { return stream.error; }
+    stream.writeBlock(first.data(), first.size());
+    stream.close();
+    //Appending without index leaves no stale index behind.
+    fileCompression appending;
+    stream.open("compressed.gz", 3, true, appending);
+    if(stream.error != 0) { return stream.error; }
+    stream.writeBlock(second.data(), second.size());
+    stream.close();
+    stream.open("compressed.gz", 1, true, compression);
+    if(stream.error != 0) { return stream.error; }
+    size_t size = stream.size();
+    stream.pointTo(1500);
+    char read = stream.readVariable<char>();
+    stream.close();
+    std::cout << size << " " << read << "\n";
+    remove("compressed.gz");
+    remove("compressed.gz.index");
+    return (size == 2000 and read == 'b')?(0):(1);
+}
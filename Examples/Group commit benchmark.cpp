@@ -0,0 +1,45 @@
+#include "LibFileStream.hpp"
+#include <atomic>
+#include <iostream>
+
+//Measures records per second and average durability latency of group commit with different batch settings.
+int main()
+{
+    const int writers = 16, records = 500;
+    const unsigned long intervals[] = {100, 1000, 5000};
+    const size_t batchSizes[] = {4096, 1 << 20};
+    std::cout << "interval(us) batch(bytes) records/s latency(us)\n";
+    for(unsigned long interval : intervals)
+    {
+        for(size_t batchSize : batchSizes)
+        {
+            remove("benchmark.log");
+            fileGroupCommit journal;
+            fileGroupCommitSettings settings;
+            settings.interval = interval;
+            settings.batchSize = batchSize;
+            journal.open("benchmark.log", 3, false, settings);
+            if(journal.error != 0) { return journal.error; }
+            std::atomic<long long> latency{0};
+            auto started = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for(int t = 0; t < writers; ++t)
+            {
+                threads.emplace_back([&]()
+                {
+                    for(int i = 0; i < records; ++i)
+                    {
+                        auto appended = std::chrono::steady_clock::now();
+                        journal.wait(journal.appendLine("event with some payload"));
+                        latency += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - appended).count();
+                    }
+                });
+            }
+            for(std::thread& thread : threads) { thread.join(); }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            journal.close();
+            std::cout << interval << " " << batchSize << " " << (long long)(writers * records / seconds) << " " << latency / (writers * records) << "\n";
+        }
+    }
+    remove("benchmark.log");
+}
@@ -0,0 +1,40 @@
+#include "LibFileStream.hpp"
+#include <iostream>
+
+//Measures time of writing temporary data and reading it back, with file and with stream kept in memory.
+int main()
+{
+    const size_t blockSize = 4096, blocks = 16384, repeats = 20;
+    std::vector<char> block(blockSize, 'x');
+    std::cout << "memory microseconds\n";
+    for(int inMemory = 0; inMemory < 2; ++inMemory)
+    {
+        auto started = std::chrono::steady_clock::now();
+        for(size_t repeat = 0; repeat < repeats; ++repeat)
+        {
+            fileStream<char> stream;
+            if(inMemory == 1)
+            {
+                stream.openMemory(fileMemory(), 5, true);
+            }
+            else
+            {
+                stream.open("benchmark.tmp", 5, true);
+            }
+            if(stream.error != 0) { return stream.error; }
+            for(size_t i = 0; i < blocks; ++i)
+            {
+                stream.writeBlock(block.data(), block.size());
+            }
+            stream.reset();
+            for(size_t i = 0; i < blocks; ++i)
+            {
+                stream.readBlockInto(block.data(), block.size());
+            }
+            stream.close();
+            remove("benchmark.tmp");
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::cout << ((inMemory == 1)?("yes"):("no")) << " " << (long long)(seconds * 1000000 / repeats) << "\n";
+    }
+}
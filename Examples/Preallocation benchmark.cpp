@@ -0,0 +1,28 @@
+#include "LibFileStream.hpp"
+#include <iostream>
+
+//Measures sustained write throughput of large binary file with and without preallocation.
+int main()
+{
+    const size_t blockSize = 1 << 20, blocks = 2048;
+    std::vector<char> block(blockSize, 'x');
+    std::cout << "preallocation MB/s\n";
+    for(int preallocated = 0; preallocated < 2; ++preallocated)
+    {
+        remove("benchmark.bin");
+        fileAllocation allocation;
+        allocation.expectedSize = (preallocated == 1)?(blockSize * blocks):(0);
+        auto started = std::chrono::steady_clock::now();
+        fileStream<char> stream("benchmark.bin", 2, true, allocation);
+        if(stream.error != 0) { return stream.error; }
+        for(size_t i = 0; i < blocks; ++i)
+        {
+            stream.writeBlock(block.data(), block.size());
+        }
+        stream.sync();
+        stream.close();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::cout << ((preallocated == 1)?("yes"):("no")) << " " << (long long)(blocks * blockSize / seconds / 1000000) << "\n";
+    }
+    remove("benchmark.bin");
+}
@@ -0,0 +1,50 @@
+#include "LibFileStream.hpp"
+#include <iostream>
+
+//Measures per-call overhead of small binary writes and reads with runtime and compile-time chosen modes.
+int main()
+{
+    const int calls = 1000000;
+    auto nanoseconds = [](std::chrono::steady_clock::time_point started)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count() / calls;
+    };
+    std::cout << "stream writeVariable(ns) readVariable(ns)\n";
+    {
+        auto started = std::chrono::steady_clock::now();
+        fileStream<char> writer("benchmark.bin", 2, true);
+        for(int i = 0; i < calls; ++i)
+        {
+            writer.writeVariable(i);
+        }
+        writer.close();
+        double written = nanoseconds(started);
+        long long sum = 0;
+        started = std::chrono::steady_clock::now();
+        fileStream<char> reader("benchmark.bin", 1, true);
+        for(int i = 0; i < calls; ++i)
+        {
+            sum += reader.readVariable<int>();
+        }
+        std::cout << "fileStream " << written << " " << nanoseconds(started) << " (" << sum << ")\n";
+    }
+    {
+        auto started = std::chrono::steady_clock::now();
+        fileStaticStream<2, true> writer("benchmark.bin");
+        for(int i = 0; i < calls; ++i)
+        {
+            writer.writeVariable(i);
+        }
+        writer.close();
+        double written = nanoseconds(started);
+        long long sum = 0;
+        started = std::chrono::steady_clock::now();
+        fileStaticStream<1, true> reader("benchmark.bin");
+        for(int i = 0; i < calls; ++i)
+        {
+            sum += reader.readVariable<int>();
+        }
+        std::cout << "fileStaticStream " << written << " " << nanoseconds(started) << " (" << sum << ")\n";
+    }
+    remove("benchmark.bin");
+}
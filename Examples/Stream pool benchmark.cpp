@@ -0,0 +1,39 @@
+#include "LibFileStream.hpp"
+#include <iostream>
+
+//Measures requests per second of repeatedly opening, reading header of and closing the same small files, with and without stream pool.
+int main()
+{
+    const int files = 1000, requests = 200000;
+    for(int i = 0; i < files; ++i)
+    {
+        fileStream<char> stream(("benchmark" + std::to_string(i) + ".txt").c_str(), 2);
+        stream.writeString<char>("first line of small file\n");
+    }
+    std::cout << "pool requests/s hit-rate\n";
+    for(int pooled = 0; pooled < 2; ++pooled)
+    {
+        fileStreamPool pool;
+        size_t read = 0;
+        auto started = std::chrono::steady_clock::now();
+        for(int i = 0; i < requests; ++i)
+        {
+            std::string path = "benchmark" + std::to_string(i % files) + ".txt";
+            fileStream<char> stream = (pooled == 1)?(pool.checkout(path.c_str(), 1, true)):(fileStream<char>(path.c_str(), 1, true));
+            if(stream.error != 0) { return stream.error; }
+            char header[16];
+            stream.readBlockInto(header, sizeof(header));
+            read += sizeof(header);
+            if(pooled == 1)
+            {
+                pool.giveBack(std::move(stream));
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::cout << ((pooled == 1)?("yes"):("no")) << " " << (long long)(requests / seconds) << " " << pool.statistics().hitRate() << "\n";
+    }
+    for(int i = 0; i < files; ++i)
+    {
+        remove(("benchmark" + std::to_string(i) + ".txt").c_str());
+    }
+}
@@ -1,1102 +1,8996 @@
 #include <cstdio>
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
+#include <chrono>
 #include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#define LIBFILESTREAM_POSIX 1
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
 //#include <sys/param.h>
 //#include <iostream>
 
 /**
- * Structure representing file stream.
- * Places own data safety at first place.
- * Use open to open file and close to close it.
- * Every file stream has defined constants mode, binary, path, end, error.
+ * Byte order helpers used by ordered binary reading and writing.
+ * Byte order supports one of the 2 values:
+ * 1 - little endian;
+ * 2 - big endian.
  */
-template<class path_type = char>
-struct fileStream
+struct fileByteOrder
 {
-    protected:
-        //Secure storage, inaccessible from outside.
+    ///Little endian byte order.
+    const static unsigned short little = 1;
 
-        ///File storage.
-        FILE* file = nullptr;
-
-        ///Mode storage.
-        unsigned short privateMode = 0;
+    ///Big endian byte order.
+    const static unsigned short big = 2;
 
-        ///Binary mode storage;
-        unsigned short privateBinaryMode = false;
+    ///Byte order of the current platform.
+    #if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    const static unsigned short native = big;
+    #else
+    const static unsigned short native = little;
+    #endif
 
-        ///Error storage.
-        int privateError = 0;
+    ///Checks whenever byte order is one of the supported values.
+    static bool isValid(unsigned short order)
+    {
+        return order == little or order == big;
+    }
 
-        ///Current path storage.
-        path_type* privatePath = nullptr;
+    ///Reverses bytes of 16 bit value.
+    static std::uint16_t swap(std::uint16_t value)
+    {
+        #ifdef __GNUC__
+        return __builtin_bswap16(value);
+        #else
+        return (std::uint16_t)((value >> 8) | (value << 8));
+        #endif
+    }
 
-        bool privateEndOfFile = false;
-    
-    private:
-        //Secure secret functions storage.
+    ///Reverses bytes of 32 bit value.
+    static std::uint32_t swap(std::uint32_t value)
+    {
+        #ifdef __GNUC__
+        return __builtin_bswap32(value);
+        #else
+        return ((value >> 24) & 0xFFu) | ((value >> 8) & 0xFF00u) | ((value << 8) & 0xFF0000u) | (value << 24);
+        #endif
+    }
 
-        //Functions from other libraries.
+    ///Reverses bytes of 64 bit value.
+    static std::uint64_t swap(std::uint64_t value)
+    {
+        #ifdef __GNUC__
+        return __builtin_bswap64(value);
+        #else
+        return ((std::uint64_t)swap((std::uint32_t)value) << 32) | swap((std::uint32_t)(value >> 32));
+        #endif
+    }
 
-        //Checks whenever it contains zero given its real or expected size.
-        template<class char_type = char>
-        static bool isStringZeroTerminated(const char_type* const& string, size_t expectedSize = 0)
+    /**Reverses bytes of every element of the array in place.
+    *Loop is kept branch free for the common widths, so compiler can vectorize it.
+    */
+    template<size_t width>
+    static void swapArray(void* data, size_t count)
+    {
+        unsigned char* bytes = static_cast<unsigned char*>(data);
+        if constexpr(width == 2 or width == 4 or width == 8)
         {
-            for(size_t i = 0; i < expectedSize; ++i)
+            using word = typename std::conditional<width == 2, std::uint16_t, typename std::conditional<width == 4, std::uint32_t, std::uint64_t>::type>::type;
+            for(size_t i = 0; i < count; ++i)
             {
-                if(string[i] == '\0')
+                word value;
+                std::memcpy(&value, bytes + i * width, width);
+                value = swap(value);
+                std::memcpy(bytes + i * width, &value, width);
+            }
+        }
+        else if constexpr(width > 1)
+        {
+            for(size_t i = 0; i < count; ++i)
+            {
+                for(size_t j = 0; j < width / 2; ++j)
                 {
-                    return true;
+                    unsigned char saved = bytes[i * width + j];
+                    bytes[i * width + j] = bytes[i * width + width - 1 - j];
+                    bytes[i * width + width - 1 - j] = saved;
                 }
             }
-            return false;
         }
+    }
 
-        //Protects from "(Function name) doesn't handle strings that are not '\0'-terminated; if given one it may perform an over-read (it could cause a crash if unprotected) (CWE-126)."
-        template<class char_type = char>
-        static void ensureZeroTerminated(char_type* string, size_t expectedSize = 0)
+    ///Converts array between native and choosen byte order in place.
+    template<class type>
+    static void convertArray(type* data, size_t count, unsigned short order)
+    {
+        static_assert(std::is_arithmetic<type>::value or std::is_enum<type>::value, "Only arithmetic and enumeration types have byte order.");
+        if(order != native)
         {
-            if(not isStringZeroTerminated<char_type>(string, expectedSize))
-            {
-                string[expectedSize - 1] = '\0';
-            }
+            swapArray<sizeof(type)>(data, count);
         }
+    }
+};
 
-        ///Copy list into another list.
-        template<class type>
-        static void copyList(const type copiedlist[], type list[], size_t size)
+/**
+ * Compile-time description of record layout in file.
+ * Lists pointers to members in the order they are stored, for example:
+ * using pointSchema = fileSchema<&point::x, &point::y>;
+ * Fields are stored packed, without padding, in choosen byte order.
+ * Fields must be arithmetic, enumeration or arrays of them.
+ */
+template<auto... members>
+struct fileSchema
+{
+    private:
+        template<class> struct memberOf;
+
+        template<class owner, class field>
+        struct memberOf<field owner::*>
         {
-            for(size_t i = 0; i < size; ++i)
+            using ownerType = owner;
+            using fieldType = field;
+        };
+
+        template<auto member>
+        using fieldOf = typename memberOf<decltype(member)>::fieldType;
+
+        template<auto member>
+        using elementOf = typename std::remove_all_extents<fieldOf<member>>::type;
+
+    public:
+        static_assert(sizeof...(members) > 0, "Schema must contain at least one field.");
+
+        ///Type of described record.
+        using recordType = typename memberOf<typename std::tuple_element<0, std::tuple<decltype(members)...>>::type>::ownerType;
+
+        static_assert((std::is_same<typename memberOf<decltype(members)>::ownerType, recordType>::value and ...), "All fields must belong to the same record.");
+        static_assert(((std::is_arithmetic<elementOf<members>>::value or std::is_enum<elementOf<members>>::value) and ...), "Fields must be arithmetic, enumeration or arrays of them.");
+
+        ///Size of one record in file.
+        const static size_t recordSize = (sizeof(fieldOf<members>) + ...);
+
+    private:
+        template<auto member>
+        static void packField(const recordType& record, unsigned char* into, size_t& offset, unsigned short order)
+        {
+            std::memcpy(into + offset, &(record.*member), sizeof(fieldOf<member>));
+            if(order != fileByteOrder::native)
             {
-                list[i] = copiedlist[i];
+                fileByteOrder::swapArray<sizeof(elementOf<member>)>(into + offset, sizeof(fieldOf<member>) / sizeof(elementOf<member>));
             }
+            offset += sizeof(fieldOf<member>);
         }
 
-        ///Adds element to list. Returns list with new element.
-        template<class type>
-        static void addToList(type* &list, size_t size, type newElement)
+        template<auto member>
+        static void unpackField(const unsigned char* from, recordType& record, size_t& offset, unsigned short order)
         {
-            type* extendedList = new type[size + 1];
-            for(size_t i = 0; i < size; ++i)
+            std::memcpy(&(record.*member), from + offset, sizeof(fieldOf<member>));
+            if(order != fileByteOrder::native)
             {
-                extendedList[i] = list[i];
+                fileByteOrder::swapArray<sizeof(elementOf<member>)>(&(record.*member), sizeof(fieldOf<member>) / sizeof(elementOf<member>));
             }
-            delete[] list;
-            extendedList[size] = newElement;
-            list = extendedList;
+            offset += sizeof(fieldOf<member>);
         }
 
-        ///Returns length of the string.
-        template<class type>
-        static size_t stringLength(const type* const& string)
+        template<auto member>
+        static bool isNextField(const recordType& record, size_t& offset)
         {
-            //for(size_t i = 0; string[i] != '\0'; ++i)
-            size_t i = 0;
-            while(string[i] != '\0')
+            bool isNext = (reinterpret_cast<const unsigned char*>(&(record.*member)) - reinterpret_cast<const unsigned char*>(&record)) == (std::ptrdiff_t)offset;
+            offset += sizeof(fieldOf<member>);
+            return isNext;
+        }
+
+        static bool computeDirect()
+        {
+            if constexpr(std::is_trivially_copyable<recordType>::value and std::is_default_constructible<recordType>::value)
             {
-                ++i;
+                if(recordSize != sizeof(recordType))
+                {
+                    return false;
+                }
+                recordType probe{};
+                size_t offset = 0;
+                return (isNextField<members>(probe, offset) and ...);
+            }
+            else
+            {
+                return false;
             }
-            return i;
         }
 
-        ///Returns copy of string.
-        template<class type>
-        type* stringCopy(const type* const& string)
+    public:
+        /**Checks whenever stored layout matches layout in memory.
+        *If so and byte order is native, records are copied without any conversion.
+        */
+        static bool isDirect()
         {
-            type* newString = new type[stringLength(string) + 1];
-            copyList<type>(string, newString, stringLength(string) + 1);
-            return newString;
+            static const bool direct = computeDirect();
+            return direct;
         }
 
-        bool isError()
+        ///Writes record into buffer of recordSize bytes.
+        static void pack(const recordType& record, unsigned char* into, unsigned short order = fileByteOrder::little)
         {
-            return (ferror(file) != 0) or (errno != 0);
+            size_t offset = 0;
+            (packField<members>(record, into, offset, order), ...);
         }
-        
-        //Clears default error variables to collect new error messages.
-        void clearErrorPointing()
+
+        ///Reads record from buffer of recordSize bytes.
+        static void unpack(const unsigned char* from, recordType& record, unsigned short order = fileByteOrder::little)
         {
-            if(ferror(file) or feof(file))
-            {
-                clearerr(file);
-            }
-            errno = 0;
+            size_t offset = 0;
+            (unpackField<members>(from, record, offset, order), ...);
         }
+};
 
-        int extractError()
+/**
+ * Settings of compressed file stream.
+ * Codec supports one of the 2 values:
+ * 1 - gzip, every block is separate gzip member, so result is readable by gzip;
+ * 2 - zlib, supports preset dictionary.
+ * Compressed streams are available when library is compiled with LIBFILESTREAM_USE_ZLIB defined and linked with zlib.
+ */
+struct fileCompression
+{
+    ///Used codec.
+    unsigned short codec = 1;
+
+    ///Compression level from 0 to 9, or -1 for the codec default.
+    int level = -1;
+
+    ///Amount of uncompressed bytes in one independently compressed block.
+    size_t blockSize = 1 << 20;
+
+    ///Preset dictionary, only for zlib codec. Copied during opening.
+    const void* dictionary = nullptr;
+
+    ///Size of preset dictionary in bytes.
+    size_t dictionarySize = 0;
+
+    ///Amount of threads compressing blocks of large writes.
+    unsigned short threads = 1;
+
+    ///Whenever block index is kept in sidecar file (path with ".index" appended) to allow fast seeking.
+    bool index = false;
+};
+
+#if defined(LIBFILESTREAM_USE_ZLIB) && defined(__GLIBC__)
+#define LIBFILESTREAM_COMPRESSION 1
+#include <zlib.h>
+
+/**
+ * State of compressed stream, connected to the C stream through fopencookie.
+ * Owns underlying file and is destroyed when C stream is closed.
+ */
+struct fileCompressionState
+{
+    ///Entry of block index.
+    struct block
+    {
+        ///Position of block start in uncompressed data.
+        std::uint64_t uncompressed = 0;
+
+        ///Position of block start in compressed file.
+        std::uint64_t compressed = 0;
+    };
+
+    ///Underlying compressed file.
+    FILE* raw = nullptr;
+
+    fileCompression settings;
+
+    std::vector<unsigned char> dictionary;
+
+    ///Path to block index, empty if index not used.
+    std::string indexPath;
+
+    std::vector<block> blocks;
+
+    bool writing = false;
+
+    ///Position in uncompressed data.
+    std::uint64_t position = 0;
+
+    //Writing storage.
+    std::vector<unsigned char> pending;
+    std::uint64_t compressedPosition = 0;
+
+    //Reading storage.
+    z_stream inflater{};
+    bool inflaterReady = false;
+    std::vector<unsigned char> input;
+    size_t inputPlace = 0;
+    size_t inputSize = 0;
+    std::vector<unsigned char> output;
+    size_t outputPlace = 0;
+    size_t outputSize = 0;
+    bool sourceEnd = false;
+    bool totalKnown = false;
+    std::uint64_t total = 0;
+
+    const static size_t chunkSize = 65536;
+
+    int windowBits() const
+    {
+        return (settings.codec == 1)?(15 + 16):(15);
+    }
+
+    ///Compresses single block into destination. Returns false on failure.
+    bool compressBlock(const unsigned char* data, size_t count, std::vector<unsigned char>& destination) const
+    {
+        z_stream deflater{};
+        if(deflateInit2(&deflater, settings.level, Z_DEFLATED, windowBits(), 8, Z_DEFAULT_STRATEGY) != Z_OK)
         {
-            if(isStreamOpen() and (ferror(file) != 0))
+            return false;
+        }
+        if(settings.codec == 2 and !dictionary.empty() and deflateSetDictionary(&deflater, dictionary.data(), (uInt)dictionary.size()) != Z_OK)
+        {
+            deflateEnd(&deflater);
+            return false;
+        }
+        destination.resize(deflateBound(&deflater, (uLong)count));
+        deflater.next_in = const_cast<unsigned char*>(data);
+        deflater.avail_in = (uInt)count;
+        deflater.next_out = destination.data();
+        deflater.avail_out = (uInt)destination.size();
+        int result = deflate(&deflater, Z_FINISH);
+        destination.resize(destination.size() - deflater.avail_out);
+        deflateEnd(&deflater);
+        return result == Z_STREAM_END;
+    }
+
+    ///Compresses and writes all full blocks of pending data, or all pending data if final.
+    bool compressPending(bool final)
+    {
+        const size_t blockSize = settings.blockSize;
+        size_t blockCount = pending.size() / blockSize;
+        if(final and pending.size() % blockSize != 0)
+        {
+            ++blockCount;
+        }
+        if(blockCount == 0)
+        {
+            return true;
+        }
+        std::vector<std::vector<unsigned char>> compressed(blockCount);
+        std::vector<char> succeeded(blockCount, 0);
+        auto compressRange = [&](size_t first, size_t step)
+        {
+            for(size_t i = first; i < blockCount; i += step)
             {
-                return ferror(file);
+                size_t start = i * blockSize;
+                size_t count = (pending.size() - start < blockSize)?(pending.size() - start):(blockSize);
+                succeeded[i] = compressBlock(pending.data() + start, count, compressed[i]);
             }
-            else if(errno != 0)
+        };
+        size_t threadCount = (settings.threads < blockCount)?(settings.threads):(blockCount);
+        if(threadCount > 1)
+        {
+            std::vector<std::thread> workers;
+            for(size_t i = 1; i < threadCount; ++i)
             {
-                return errno;
+                workers.emplace_back(compressRange, i, threadCount);
             }
-            else
+            compressRange(0, threadCount);
+            for(std::thread& worker : workers)
             {
-                return privateError;
+                worker.join();
             }
-            return 0;
         }
-
-        ///Updates End Of File information to insure, that clearerr can't remove end of file data.
-        void updateEndOfFile()
+        else
         {
-            if(point() >= size())
+            compressRange(0, 1);
+        }
+        std::uint64_t uncompressedStart = position - pending.size();
+        for(size_t i = 0; i < blockCount; ++i)
+        {
+            if(!succeeded[i] or fwrite(compressed[i].data(), 1, compressed[i].size(), raw) != compressed[i].size())
             {
-                privateEndOfFile = true;
+                errno = (errno != 0)?(errno):(EIO);
+                return false;
             }
-            privateEndOfFile = (privateEndOfFile)?(true):(feof(file));
+            if(!indexPath.empty())
+            {
+                blocks.push_back({uncompressedStart + i * blockSize, compressedPosition});
+            }
+            compressedPosition += compressed[i].size();
         }
+        size_t consumed = (blockCount * blockSize < pending.size())?(blockCount * blockSize):(pending.size());
+        pending.erase(pending.begin(), pending.begin() + consumed);
+        return true;
+    }
 
-        public:
-
-        fileStream(fileStream&& movedFrom)
+    ///Loads block index. Returns false if there is no valid index, or it describes compressed file of other length.
+    bool loadIndex()
+    {
+        FILE* indexFile = fopen(indexPath.c_str(), "rb");
+        if(indexFile == nullptr)
         {
-            close();
-            file = movedFrom.file;
-            movedFrom.file = nullptr;
-            privateMode = movedFrom.privateMode;
-            movedFrom.privateMode = 0;
-            privateBinaryMode = movedFrom.privateBinaryMode;
-            movedFrom.privateBinaryMode = false;
-            privateEndOfFile = movedFrom.privateEndOfFile;
-            movedFrom.privateEndOfFile = false;
-            privatePath = movedFrom.privatePath;
-            movedFrom.privatePath = nullptr;
+            return false;
+        }
+        std::uint64_t header[4] = {0, 0, 0, 0};
+        bool valid = fread(header, sizeof(std::uint64_t), 4, indexFile) == 4;
+        fileByteOrder::convertArray(header, 4, fileByteOrder::little);
+        valid = valid and header[0] == 0x3244494D5346424CULL;
+        //File changed without updating index, for example by appending without index, is detected by its length.
+        struct stat information;
+        valid = valid and fstat(fileno(raw), &information) == 0 and (std::uint64_t)information.st_size == header[2];
+        if(valid)
+        {
+            std::vector<std::uint64_t> entries(header[3] * 2);
+            valid = fread(entries.data(), sizeof(std::uint64_t), entries.size(), indexFile) == entries.size();
+            fileByteOrder::convertArray(entries.data(), entries.size(), fileByteOrder::little);
+            blocks.clear();
+            for(size_t i = 0; valid and i < header[3]; ++i)
+            {
+                blocks.push_back({entries[i * 2], entries[i * 2 + 1]});
+            }
+            total = header[1];
+            totalKnown = valid;
+        }
+        fclose(indexFile);
+        if(!valid)
+        {
+            blocks.clear();
         }
+        return valid;
+    }
 
-        ///Checks whenever stream is open.
-        bool isStreamOpen() const
+    ///Saves block index. Format is magic, total size, compressed size, block count and block pairs, all as little endian 64 bit numbers.
+    bool saveIndex()
+    {
+        FILE* indexFile = fopen(indexPath.c_str(), "wb");
+        if(indexFile == nullptr)
         {
-            return file != nullptr and privateMode != 0;
+            return false;
+        }
+        std::vector<std::uint64_t> entries = {0x3244494D5346424CULL, position, compressedPosition, (std::uint64_t)blocks.size()};
+        for(const block& entry : blocks)
+        {
+            entries.push_back(entry.uncompressed);
+            entries.push_back(entry.compressed);
         }
+        fileByteOrder::convertArray(entries.data(), entries.size(), fileByteOrder::little);
+        bool saved = fwrite(entries.data(), sizeof(std::uint64_t), entries.size(), indexFile) == entries.size();
+        return (fclose(indexFile) == 0) and saved;
+    }
 
-        ///Checks whenever stream is valid for reading.
-        bool isValidForReading() const
+    ///Restarts decompression from choosen block.
+    bool restart(const block& from)
+    {
+        if(fseek(raw, (long)from.compressed, SEEK_SET) != 0)
         {
-            return file != nullptr and !privateEndOfFile and (privateMode == 1 or (privateMode >= 4 and privateMode <= 6));
+            return false;
         }
+        inflateReset(&inflater);
+        inputPlace = inputSize = 0;
+        outputPlace = outputSize = 0;
+        sourceEnd = false;
+        position = from.uncompressed;
+        return true;
+    }
 
-        //Checks whenever stream is valid for writing.
-        bool isValidForWriting() const
+    ///Decompresses next part of data into output. Returns false at the end of data.
+    bool fill()
+    {
+        outputPlace = outputSize = 0;
+        while(true)
         {
-            return file != nullptr and (privateMode >= 2 and privateMode <= 6);
+            if(inputPlace == inputSize and !sourceEnd)
+            {
+                inputSize = fread(input.data(), 1, input.size(), raw);
+                inputPlace = 0;
+                if(inputSize == 0)
+                {
+                    sourceEnd = true;
+                    if(ferror(raw))
+                    {
+                        errno = EIO;
+                        return false;
+                    }
+                }
+            }
+            inflater.next_in = input.data() + inputPlace;
+            inflater.avail_in = (uInt)(inputSize - inputPlace);
+            inflater.next_out = output.data();
+            inflater.avail_out = (uInt)output.size();
+            int result = inflate(&inflater, Z_NO_FLUSH);
+            if(result == Z_NEED_DICT)
+            {
+                if(dictionary.empty() or inflateSetDictionary(&inflater, dictionary.data(), (uInt)dictionary.size()) != Z_OK)
+                {
+                    errno = EIO;
+                    return false;
+                }
+                inputPlace = inputSize - inflater.avail_in;
+                continue;
+            }
+            inputPlace = inputSize - inflater.avail_in;
+            outputSize = output.size() - inflater.avail_out;
+            if(result == Z_STREAM_END)
+            {
+                //Next block is separate stream.
+                inflateReset(&inflater);
+            }
+            else if(result != Z_OK and result != Z_BUF_ERROR)
+            {
+                errno = EIO;
+                return false;
+            }
+            if(outputSize > 0)
+            {
+                return true;
+            }
+            if(sourceEnd and inputPlace == inputSize)
+            {
+                return false;
+            }
         }
+    }
 
-        ///Checks whenever stream is valid for reading.
-        bool isValidForTextReading() const
+    ///Skips choosen amount of uncompressed data. Returns false if data ended earlier.
+    bool skip(std::uint64_t count)
+    {
+        while(count > 0)
         {
-            return file != nullptr and !privateEndOfFile and (privateMode == 1 or (privateMode >= 4 and privateMode <= 6)) and !privateBinaryMode;
+            if(outputPlace == outputSize and !fill())
+            {
+                return false;
+            }
+            size_t part = ((std::uint64_t)(outputSize - outputPlace) < count)?(outputSize - outputPlace):((size_t)count);
+            outputPlace += part;
+            position += part;
+            count -= part;
         }
+        return true;
+    }
 
-        //Checks whenever stream is valid for writing.
-        bool isValidForTextWriting() const
+    ///Checks whenever all data is read.
+    bool isEnd()
+    {
+        if(writing)
         {
-            return file != nullptr and (privateMode >= 2 and privateMode <= 6) and !privateBinaryMode;
+            return true;
         }
+        return outputPlace == outputSize and !fill();
+    }
 
-        ///Checks whenever stream is valid for binary reading.
-        bool isValidForBinaryReading() const
+    ///Finds total uncompressed size.
+    bool findTotal()
+    {
+        if(totalKnown)
         {
-            return (file != nullptr) and (!privateEndOfFile) and (privateMode == 1 or (privateMode >= 4 and privateMode <= 6)) and privateBinaryMode;
+            return true;
         }
+        std::uint64_t saved = position;
+        while(skip(chunkSize));
+        total = position;
+        totalKnown = true;
+        return restart({0, 0}) and skip(saved);
+    }
 
-        ///Checks whenever stream is valid for binary writing.
-        bool isValidForBinaryWriting() const
+    static ssize_t read(void* cookie, char* buffer, size_t size)
+    {
+        fileCompressionState* state = static_cast<fileCompressionState*>(cookie);
+        size_t done = 0;
+        while(done < size)
         {
-            return file != nullptr and (privateMode >= 2 and privateMode <= 6) and privateBinaryMode;
+            if(state->outputPlace == state->outputSize and !state->fill())
+            {
+                break;
+            }
+            size_t part = (state->outputSize - state->outputPlace < size - done)?(state->outputSize - state->outputPlace):(size - done);
+            std::memcpy(buffer + done, state->output.data() + state->outputPlace, part);
+            state->outputPlace += part;
+            done += part;
         }
+        state->position += done;
+        return (ssize_t)done;
+    }
 
-        private:
+    static ssize_t write(void* cookie, const char* buffer, size_t size)
+    {
+        fileCompressionState* state = static_cast<fileCompressionState*>(cookie);
+        state->pending.insert(state->pending.end(), buffer, buffer + size);
+        state->position += size;
+        if(state->pending.size() >= state->settings.blockSize * state->settings.threads and !state->compressPending(false))
+        {
+            return -1;
+        }
+        return (ssize_t)size;
+    }
 
-        //Checks whenever two lists are equal.
-        template<class type>
-        static bool equalList(const type list1[], const type list2[], size_t size)
+    static int seek(void* cookie, off64_t* offset, int whence)
+    {
+        fileCompressionState* state = static_cast<fileCompressionState*>(cookie);
+        std::uint64_t target = 0;
+        switch(whence)
         {
-            bool isEqual = true;
-            for(size_t i = 0; i < size; ++i)
+            default: errno = EINVAL; return -1;
+            case SEEK_SET: target = *offset; break;
+            case SEEK_CUR: target = state->position + *offset; break;
+            case SEEK_END:
+                if(!state->writing and !state->findTotal())
+                {
+                    errno = EIO;
+                    return -1;
+                }
+                target = ((state->writing)?(state->position):(state->total)) + *offset;
+                break;
+        }
+        if(target == state->position)
+        {
+            *offset = (off64_t)target;
+            return 0;
+        }
+        if(state->writing)
+        {
+            //Compressed data is written only sequentially.
+            errno = ESPIPE;
+            return -1;
+        }
+        if(target < state->position or !state->blocks.empty())
+        {
+            block from{0, 0};
+            for(const block& entry : state->blocks)
             {
-                if(list1[i] != list2[i])
+                if(entry.uncompressed > target)
                 {
-                    isEqual = false;
                     break;
                 }
+                from = entry;
             }
-            return isEqual;
+            if(target < state->position or from.uncompressed > state->position)
+            {
+                if(!state->restart(from))
+                {
+                    errno = EIO;
+                    return -1;
+                }
+            }
+        }
+        if(!state->skip(target - state->position))
+        {
+            errno = EINVAL;
+            return -1;
         }
+        *offset = (off64_t)state->position;
+        return 0;
+    }
 
-        //Checks whenever strings are same.
-        template<class type>
-        static bool isStringsEqual(const type* const& string1, const type* const& string2)
+    static int close(void* cookie)
+    {
+        fileCompressionState* state = static_cast<fileCompressionState*>(cookie);
+        bool succeeded = true;
+        if(state->writing)
         {
-            if(stringLength(string1) != stringLength(string2))
+            succeeded = state->compressPending(true);
+            succeeded = (fflush(state->raw) == 0) and succeeded;
+            if(!state->indexPath.empty())
             {
-                return false;
+                succeeded = state->saveIndex() and succeeded;
             }
-            return equalList<type>(string1, string2, stringLength(string2));
         }
+        if(state->inflaterReady)
+        {
+            inflateEnd(&state->inflater);
+        }
+        succeeded = (fclose(state->raw) == 0) and succeeded;
+        delete state;
+        return (succeeded)?(0):(EOF);
+    }
 
-        ///Disallow unauthorized creation of file stream copies.
-        fileStream<path_type>( const fileStream<path_type>&) = delete;
-
-    public:
-        //Data, available to anything outside structure.
+    /**Opens compressed C stream. Opening mode supports:
+    *1 - read only;
+    *2 - write only;
+    *3 - append only.
+    *Returns nullptr and sets errno on failure.
+    */
+    static FILE* open(const char* path, unsigned short openingMode, const fileCompression& settings, fileCompressionState** created)
+    {
+        if((openingMode < 1 or openingMode > 3) or (settings.codec != 1 and settings.codec != 2) or settings.level < -1 or settings.level > 9 or settings.blockSize == 0 or settings.threads == 0 or (settings.codec == 1 and settings.dictionarySize != 0))
+        {
+            errno = ENOTSUP;
+            return nullptr;
+        }
+        fileCompressionState* state = new fileCompressionState;
+        state->settings = settings;
+        state->writing = openingMode != 1;
+        if(settings.dictionary != nullptr)
+        {
+            const unsigned char* dictionaryBytes = static_cast<const unsigned char*>(settings.dictionary);
+            state->dictionary.assign(dictionaryBytes, dictionaryBytes + settings.dictionarySize);
+        }
+        std::string indexPath = std::string(path) + ".index";
+        if(openingMode == 2 or (openingMode == 3 and !settings.index))
+        {
+            //Index of overwritten file, or of file appended to without index, is stale.
+            remove(indexPath.c_str());
+            errno = 0;
+        }
+        state->raw = fopen(path, (openingMode == 1)?("rb"):((openingMode == 2)?("wb"):("ab")));
+        if(state->raw == nullptr)
+        {
+            delete state;
+            return nullptr;
+        }
+        if(settings.index)
+        {
+            state->indexPath = indexPath;
+        }
+        if(openingMode == 1)
+        {
+            if(inflateInit2(&state->inflater, state->windowBits()) != Z_OK)
+            {
+                fclose(state->raw);
+                delete state;
+                errno = ENOMEM;
+                return nullptr;
+            }
+            state->inflaterReady = true;
+            state->input.resize(chunkSize);
+            state->output.resize(chunkSize);
+            if(!state->indexPath.empty())
+            {
+                state->loadIndex();
+            }
+        }
+        else if(openingMode == 3)
+        {
+            fseek(state->raw, 0, SEEK_END);
+            state->compressedPosition = (std::uint64_t)ftell(state->raw);
+            if(!state->indexPath.empty() and state->compressedPosition != 0)
+            {
+                //Earlier part of file can be indexed only if its index exists.
+                if(state->loadIndex())
+                {
+                    state->position = state->total;
+                }
+                else
+                {
+                    remove(indexPath.c_str());
+                    state->indexPath.clear();
+                }
+            }
+            else if(!state->indexPath.empty())
+            {
+                remove(indexPath.c_str());
+            }
+            errno = 0;
+        }
+        cookie_io_functions_t functions = {&fileCompressionState::read, &fileCompressionState::write, &fileCompressionState::seek, &fileCompressionState::close};
+        FILE* file = fopencookie(state, (openingMode == 1)?("r"):((openingMode == 2)?("w"):("a")), functions);
+        if(file == nullptr)
+        {
+            if(state->inflaterReady)
+            {
+                inflateEnd(&state->inflater);
+            }
+            fclose(state->raw);
+            delete state;
+            return nullptr;
+        }
+        if(openingMode == 1)
+        {
+            //Compressed data already buffered by state, so end of file can be checked exactly.
+            setvbuf(file, nullptr, _IONBF, 0);
+        }
+        else
+        {
+            setvbuf(file, nullptr, _IOFBF, chunkSize);
+        }
+        *created = state;
+        return file;
+    }
+};
+#else
+struct fileCompressionState;
+#endif
 
-        ///Allow sending file stream in correct way.
-        fileStream<path_type>() = default;
+/**
+ * Line index of text file. Keeps start of every interval-th line, so any line is reachable with short scan.
+ */
+struct fileLineIndex
+{
+    ///Amount of lines between stored line starts.
+    std::uint64_t interval = 4096;
 
-        ///Default error code of all functions.
-        const static unsigned short defaultErrorCode = 112;
-        
-        //const unsigned short defaultErrorCode = 1; //Invalid use of non-static data member 'defaultErrorCode' (non static? Hm...)
+    ///Amount of indexed bytes from the file start.
+    std::uint64_t indexedSize = 0;
 
-        ///Opened file mode. 1 = read; 2 = write; 3 = append; 4 = read and write, but file must exist; 5 = read and write; 6 = read and append. Uneditable from outside.
-        const unsigned short &mode = privateMode;
+    ///Amount of '\n' characters in indexed bytes.
+    std::uint64_t newlines = 0;
 
-        ///Is binary mode used.
-        const unsigned short &binary = privateBinaryMode;
+    ///Whenever indexed bytes end with '\n'.
+    bool endsWithNewline = true;
 
-        ///Last error storage. Uneditable from outside.
-        const int &error = privateError;
+    ///Starts of lines 0, interval, 2 * interval and so on.
+    std::vector<std::uint64_t> checkpoints = {0};
 
-        ///Securely stored uneditable path to current file.
-        const path_type* const &path = privatePath;
+    ///Checksum of last indexed bytes, stored in sidecar to find file rewritten since.
+    std::uint64_t stamp = 0;
 
-        ///Checks whenever it is end of file.
-        const bool &end = privateEndOfFile;
+    ///Amount of last indexed bytes covered by stamp.
+    const static size_t stampSize = 4096;
 
-        ///Cleans errors history.
-        void cleanError()
+    const static size_t scanBufferSize = 1 << 20;
+
+    ///Ranges smaller than this are scanned by single thread.
+    const static std::uint64_t parallelThreshold = 16 << 20;
+
+    ///Returns amount of lines. Last line without '\n' is counted too.
+    std::uint64_t lines() const
+    {
+        return newlines + ((indexedSize > 0 and !endsWithNewline)?(1):(0));
+    }
+
+    /**Counts '\n' characters in range of file, given amount of them before range.
+    *If checkpoints given, adds starts of every interval-th line to them.
+    */
+    static bool scanRange(const char* path, std::uint64_t from, std::uint64_t to, std::uint64_t before, std::uint64_t interval, std::vector<std::uint64_t>* checkpoints, std::uint64_t& counted)
+    {
+        counted = 0;
+        if(from >= to)
         {
-            if(isStreamOpen())
-            {
-                clearErrorPointing();
-            }
-            privateError = 0;
+            return true;
         }
-
-        ///Cleans error and returns true if error is same as given error.
-        bool ignoreError(const int &ignoredError)
+        FILE* source = fopen(path, "rb");
+        if(source == nullptr)
         {
-            if(privateError == ignoredError)
+            return false;
+        }
+        bool succeeded = fseek(source, (long)from, SEEK_SET) == 0;
+        char* buffer = new char[scanBufferSize];
+        for(std::uint64_t place = from; succeeded and place < to;)
+        {
+            size_t wanted = (to - place < scanBufferSize)?((size_t)(to - place)):(scanBufferSize);
+            size_t result = fread(buffer, 1, wanted, source);
+            if(result == 0)
             {
-                privateError = 0;
-                return true;
+                succeeded = false;
+                break;
             }
-            else
+            for(const char* found = static_cast<const char*>(std::memchr(buffer, '\n', result)); found != nullptr; found = static_cast<const char*>(std::memchr(found + 1, '\n', result - (size_t)(found + 1 - buffer))))
             {
-                return false;
+                ++counted;
+                if(checkpoints != nullptr and (before + counted) % interval == 0)
+                {
+                    checkpoints->push_back(place + (std::uint64_t)(found - buffer) + 1);
+                }
             }
+            place += result;
         }
+        delete[] buffer;
+        fclose(source);
+        return succeeded;
+    }
 
-        ///Function to send error to another function.
-        void handle(bool(handlingFunction)(const unsigned short &))
+    /**Extends index up to choosen size of file, which must only have been appended to.
+    *Large ranges are scanned in parallel: first pass counts lines of every part, second collects line starts.
+    */
+    bool extend(const char* path, std::uint64_t newSize, unsigned threads)
+    {
+        if(newSize <= indexedSize)
         {
-            if(!isError())
+            return newSize == indexedSize;
+        }
+        std::uint64_t from = indexedSize;
+        std::uint64_t range = newSize - from;
+        if(threads < 2 or range < parallelThreshold)
+        {
+            std::uint64_t counted = 0;
+            if(!scanRange(path, from, newSize, newlines, interval, &checkpoints, counted))
             {
-                return;
+                return false;
             }
-            bool shouldClose = handlingFunction(extractError());
-            if(shouldClose)
+            newlines += counted;
+        }
+        else
+        {
+            std::uint64_t part = range / threads + 1;
+            std::vector<std::uint64_t> counts(threads, 0);
+            std::vector<std::vector<std::uint64_t>> found(threads);
+            std::vector<char> succeeded(threads, 1);
+            auto pass = [&](bool collect)
             {
-                close();
+                std::vector<std::thread> workers;
+                std::uint64_t before = newlines;
+                for(unsigned i = 0; i < threads; ++i)
+                {
+                    std::uint64_t start = from + part * i;
+                    std::uint64_t end = (start + part < newSize)?(start + part):(newSize);
+                    workers.emplace_back([&, i, start, end, before]()
+                    {
+                        std::uint64_t counted = 0;
+                        succeeded[i] = scanRange(path, (start < newSize)?(start):(newSize), end, before, interval, (collect)?(&found[i]):(nullptr), counted) and succeeded[i];
+                        if(!collect)
+                        {
+                            counts[i] = counted;
+                        }
+                    });
+                    before += (collect)?(counts[i]):(0);
+                }
+                for(std::thread& worker : workers)
+                {
+                    worker.join();
+                }
+            };
+            pass(false);
+            pass(true);
+            for(unsigned i = 0; i < threads; ++i)
+            {
+                if(!succeeded[i])
+                {
+                    return false;
+                }
+                checkpoints.insert(checkpoints.end(), found[i].begin(), found[i].end());
+                newlines += counts[i];
             }
         }
+        FILE* source = fopen(path, "rb");
+        if(source == nullptr)
+        {
+            return false;
+        }
+        fseek(source, (long)(newSize - 1), SEEK_SET);
+        endsWithNewline = fgetc(source) == '\n';
+        fclose(source);
+        indexedSize = newSize;
+        return true;
+    }
+};
 
-        ///Placement in file.
-        size_t point(int errorCode = defaultErrorCode)
+/**
+ * Durability settings of file stream.
+ * Synchronization supports one of the 2 values:
+ * 1 - fdatasync, synchronizes data and only metadata needed to read it;
+ * 2 - fsync, synchronizes data and all metadata.
+ */
+struct fileDurability
+{
+    ///Used synchronization.
+    unsigned short synchronization = 2;
+
+    ///Amount of written bytes after which their writeback is started in background, 0 disables it. Uses sync_file_range where available.
+    size_t backgroundFlush = 0;
+
+    ///Synchronizes file descriptor. Returns false and sets errno on failure.
+    static bool synchronize(int descriptor, unsigned short synchronization)
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        #if defined(_POSIX_SYNCHRONIZED_IO) && (_POSIX_SYNCHRONIZED_IO > 0)
+        if(synchronization == 1)
         {
-            if(!isStreamOpen())
+            return fdatasync(descriptor) == 0;
+        }
+        #endif
+        (void)synchronization;
+        return fsync(descriptor) == 0;
+        #else
+        (void)descriptor;
+        (void)synchronization;
+        errno = ENOTSUP;
+        return false;
+        #endif
+    }
+
+    ///Synchronizes directory containing choosen path, so renaming in it becomes durable.
+    static bool synchronizeDirectory(const char* path)
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        std::string directory = path;
+        size_t separator = directory.find_last_of('/');
+        directory = (separator == std::string::npos)?("."):((separator == 0)?("/"):(directory.substr(0, separator)));
+        int descriptor = ::open(directory.c_str(), O_RDONLY);
+        if(descriptor < 0)
+        {
+            return false;
+        }
+        bool succeeded = fsync(descriptor) == 0;
+        ::close(descriptor);
+        return succeeded;
+        #else
+        (void)path;
+        errno = ENOTSUP;
+        return false;
+        #endif
+    }
+};
+
+/**
+ * State of atomically written file stream.
+ * Data is written into temporary file near the target, which replaces target only on commit.
+ */
+struct fileAtomicState
+{
+    ///Path of the temporary file.
+    std::string temporaryPath;
+
+    fileDurability durability;
+
+    ///Position up to which background writeback was started.
+    std::uint64_t flushed = 0;
+
+    /**Creates temporary file in the same directory as target. Permissions of existing target are kept.
+    *Returns descriptor, or -1 and sets errno on failure.
+    */
+    int create(const char* target)
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        //Streams of several threads may create temporary files at once.
+        static std::atomic<unsigned> counter{0};
+        for(unsigned attempt = 0; attempt < 100; ++attempt)
+        {
+            temporaryPath = std::string(target) + ".tmp." + std::to_string((long)getpid()) + "." + std::to_string(++counter);
+            int descriptor = ::open(temporaryPath.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+            if(descriptor >= 0)
             {
-                privateError = errorCode;
-                return 0;
+                struct stat existing;
+                if(stat(target, &existing) == 0)
+                {
+                    fchmod(descriptor, existing.st_mode & 07777);
+                }
+                errno = 0;
+                return descriptor;
             }
-            if(mode == 3)
+            if(errno != EEXIST)
             {
-                return 0;
+                return -1;
             }
-            return ftell(file);
         }
+        return -1;
+        #else
+        (void)target;
+        errno = ENOTSUP;
+        return -1;
+        #endif
+    }
 
-        ///Returns error and clears last error history. Warning! Function not failsafe, and will crash if unsuitable problems occur.
-        int getError()
+    ///Starts background writeback of data written since last call, once there is enough of it.
+    void backgroundFlush(FILE* file)
+    {
+        #if defined(__linux__) && defined(_GNU_SOURCE)
+        if(durability.backgroundFlush == 0)
         {
-            int returned = privateError;
-            cleanError();
-            return returned;
+            return;
+        }
+        long place = ftell(file);
+        if(place < 0 or (std::uint64_t)place < flushed + durability.backgroundFlush)
+        {
+            return;
+        }
+        if(fflush(file) == 0)
+        {
+            sync_file_range(fileno(file), (off64_t)flushed, (off64_t)((std::uint64_t)place - flushed), SYNC_FILE_RANGE_WRITE);
         }
+        flushed = (std::uint64_t)place;
+        errno = 0; //Background writeback is only a hint.
+        #else
+        (void)file;
+        #endif
+    }
+};
 
-        /*Returns file pointer and automatically closes file stream.
-        Caution! Pointer goes out of file stream scope. File stream will be closed after this operation automatically to prevent non library-dependent and broken behavoir.*/
-        FILE* extractPointer()
+/**
+ * Entry of directory returned by directory scanning.
+ * Type supports one of the 5 values:
+ * 0 - unknown;
+ * 1 - regular file;
+ * 2 - directory;
+ * 3 - symbolic link;
+ * 4 - other.
+ */
+struct fileDirectoryEntry
+{
+    ///Name of entry, valid until next scanning call.
+    const char* name = nullptr;
+
+    ///Type of entry.
+    unsigned short type = 0;
+
+    ///Inode number of entry.
+    std::uint64_t inode = 0;
+};
+
+/**
+ * Structure representing open directory.
+ * File streams can be opened relative to it, without resolving full path again.
+ * Directory is scanned in large batches, returning entries ready to be opened.
+ * Use open to open directory and close to close it.
+ */
+struct fileDirectory
+{
+    protected:
+        ///Directory descriptor, -1 if closed.
+        int descriptor = -1;
+
+        ///Error storage.
+        int privateError = 0;
+
+        ///Path of directory, as given on opening.
+        std::string privatePath;
+
+        //Scanning storage.
+        std::vector<char> buffer;
+        size_t bufferPlace = 0;
+        size_t bufferSize = 0;
+        unsigned short typeFilter = 0;
+        bool scanEnd = false;
+
+        ///Size of buffer filled by single system call.
+        const static size_t scanBufferSize = 1 << 16;
+
+        #if defined(__linux__)
+        ///Layout of entries returned by getdents64.
+        struct linuxEntry
         {
-            privateMode = 0;
-            privateBinaryMode = false;
-            if(privatePath != nullptr)
+            std::uint64_t inode;
+            std::int64_t offset;
+            unsigned short length;
+            unsigned char type;
+            char name[1];
+        };
+        #elif defined(LIBFILESTREAM_POSIX)
+        DIR* reader = nullptr;
+        #endif
+
+    private:
+        #ifdef LIBFILESTREAM_POSIX
+        static unsigned short convertType(unsigned char type)
+        {
+            switch(type)
             {
-                delete[] privatePath;
-                privatePath = nullptr;
+                case DT_REG: return 1;
+                case DT_DIR: return 2;
+                case DT_LNK: return 3;
+                case DT_UNKNOWN: return 0;
+                default: return 4;
             }
-            FILE* savedFile = file;
-            file = nullptr;
-            privateEndOfFile = false;
-            return savedFile;
         }
 
-        /**Opens stream with choosen parameters.
-        *Opening mode supports one of the 6 values. Those are:
-        *1 - read only;
-        *2 - write only;
-        *3 - append only;
-        *4 - read and write, but file should exist;
-        *5 - read and write, but file will be created;
-        *6 - read and append.
-        *To choose whenever or not use binary mode use third bool parameter.
-        */
-        void open(const path_type* const& choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        ///Finds type of entry, which file system didn't report.
+        unsigned short resolveType(const char* name) const
         {
-            //ensureZeroTerminated(choosenPath, PATH_MAX); ///Since no legal path bigger than this constant exists, we can succesfully cut any path bigger than this.
-            if(!isStringZeroTerminated(choosenPath, PATH_MAX / (sizeof(path_type) * 8)))
+            struct stat information;
+            if(fstatat(descriptor, name, &information, AT_SYMLINK_NOFOLLOW) != 0)
             {
-                //Either file too long or this isn't valid string.
-                privateError = ENAMETOOLONG;
-                return;
+                return 0;
             }
-            // if((openingMode == 1 or openingMode == 4) and !realpath(choosenPath, NULL))
-            // {
-            //     //Path nonexistant.
-            //     //privateError = ENOENT;
-            //     privateError = ENOTDIR;
-            //     return;
-            // }
-            if(choosenPath == nullptr or isStreamOpen())
+            if(S_ISREG(information.st_mode))
             {
-                //Ensure nothing will be broken.
-                privateError = errorCode;
-                return;
+                return 1;
             }
-            //assert(file);
-            switch(openingMode)
+            if(S_ISDIR(information.st_mode))
             {
-                default: privateError = errorCode; return;
-                case 1: file = fopen(choosenPath, (binaryMode)?("rb"):("r")); break;
-                case 2: file = fopen(choosenPath, (binaryMode)?("wb"):("w")); break;
-                case 3: file = fopen(choosenPath, (binaryMode)?("ab"):("a")); break;
-                case 4: file = fopen(choosenPath, (binaryMode)?("rb+"):("r+")); break;
-                case 5: file = fopen(choosenPath, (binaryMode)?("wb+"):("w+")); break;
-                case 6: file = fopen(choosenPath, (binaryMode)?("ab+"):("a+")); break;
+                return 2;
             }
-            if(file == nullptr)
+            if(S_ISLNK(information.st_mode))
             {
-                privateError = extractError();
-                return;
+                return 3;
             }
-            privateBinaryMode = binaryMode;
-            privateMode = openingMode;
-            privatePath = stringCopy<path_type>(choosenPath);
-            updateEndOfFile();
+            return 4;
         }
+        #endif
 
-        /**Opens stream with choosen parameters.
-        *Opening mode supports one of the 6 values. Those are:
-        *1 - read only;
-        *2 - write only;
-        *3 - append only;
-        *4 - read and write, but file should exist;
-        *5 - read and write, but file will be created;
-        *6 - read and append.
-        *To choose whenever or not use binary mode use third bool parameter.
-        */
-        fileStream(const path_type* const& choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        ///Takes next raw entry. Returns false at the end of directory or on error.
+        bool nextRaw(fileDirectoryEntry& entry)
         {
-            open(choosenPath, openingMode, binaryMode, errorCode);
+            #if defined(__linux__)
+            if(bufferPlace >= bufferSize)
+            {
+                if(scanEnd)
+                {
+                    return false;
+                }
+                long result = syscall(SYS_getdents64, descriptor, buffer.data(), buffer.size());
+                if(result <= 0)
+                {
+                    scanEnd = true;
+                    if(result < 0)
+                    {
+                        privateError = errno;
+                    }
+                    return false;
+                }
+                bufferPlace = 0;
+                bufferSize = (size_t)result;
+            }
+            linuxEntry* current = reinterpret_cast<linuxEntry*>(buffer.data() + bufferPlace);
+            bufferPlace += current->length;
+            entry.name = current->name;
+            entry.type = convertType(current->type);
+            entry.inode = current->inode;
+            return true;
+            #elif defined(LIBFILESTREAM_POSIX)
+            errno = 0;
+            dirent* current = (reader != nullptr)?(readdir(reader)):(nullptr);
+            if(current == nullptr)
+            {
+                scanEnd = true;
+                if(errno != 0)
+                {
+                    privateError = errno;
+                }
+                return false;
+            }
+            entry.name = current->d_name;
+            entry.type = convertType(current->d_type);
+            entry.inode = current->d_ino;
+            return true;
+            #else
+            (void)entry;
+            return false;
+            #endif
         }
 
-        /**Closes stream. No parameters needed.
-        *Can and must be called even if the stream has been corrupted.
-        */
-        void close()
+        void openDescriptor(int parent, const char* choosenPath, int errorCode)
         {
-            if(file != nullptr)
+            #ifdef LIBFILESTREAM_POSIX
+            if(descriptor >= 0 or choosenPath == nullptr)
             {
-                //rewind(file);
-                fclose(file);
-                file = nullptr;
+                privateError = errorCode;
+                return;
             }
-            privateMode = 0;
-            privateBinaryMode = false;
-            //privateError = 0; //No need to clear last error log.
-            privateEndOfFile = false;
-            if(privatePath != nullptr)
+            descriptor = openat(parent, choosenPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if(descriptor < 0)
             {
-                delete[] privatePath;
-                privatePath = nullptr;
+                privateError = errno;
+                return;
             }
+            privatePath = choosenPath;
+            scan();
+            #else
+            (void)parent;
+            (void)choosenPath;
+            (void)errorCode;
+            privateError = ENOTSUP;
+            #endif
         }
 
-        ///Close file stream automatically during destruction.
-        ~fileStream()
-        {
-            close();
-        }
+    public:
+        ///Last error storage. Uneditable from outside.
+        const int &error = privateError;
 
-        /**Reopen file at the same path but in different mode.
+        ///Path of directory. Uneditable from outside.
+        const std::string &path = privatePath;
+
+        fileDirectory() = default;
+
+        fileDirectory(const fileDirectory&) = delete;
+
+        ///Error code reported by default, the same as in file stream.
+        const static unsigned short defaultErrorCode = 112;
+
+        /**Opens directory at choosen path.
+        *Syntax is following:
+        *directoryName.open("directory");
+        */
+        void open(const char* choosenPath, int errorCode = defaultErrorCode)
+        {
+            privateError = 0;
+            #ifdef LIBFILESTREAM_POSIX
+            openDescriptor(AT_FDCWD, choosenPath, errorCode);
+            #else
+            openDescriptor(-1, choosenPath, errorCode);
+            #endif
+        }
+
+        /**Opens directory relative to another open directory, allowing fast walking of directory trees.
+        *Syntax is following:
+        *directoryName.open(parentDirectoryName, entry.name);
+        */
+        void open(const fileDirectory& parent, const char* name, int errorCode = defaultErrorCode)
+        {
+            privateError = 0;
+            if(parent.descriptor < 0)
+            {
+                privateError = errorCode;
+                return;
+            }
+            openDescriptor(parent.descriptor, name, errorCode);
+            if(descriptor >= 0)
+            {
+                privatePath = parent.joinedPath(name);
+            }
+        }
+
+        ///Returns path naming entry opened relative to directory. Absolute name is opened as it is, so it is returned as it is.
+        std::string joinedPath(const char* name) const
+        {
+            if(name[0] == '/')
+            {
+                return name;
+            }
+            return (privatePath.empty() or privatePath.back() == '/')?(privatePath + name):(privatePath + "/" + name);
+        }
+
+        ///Checks whenever directory is open.
+        bool isOpen() const
+        {
+            return descriptor >= 0;
+        }
+
+        ///Returns descriptor for functions working relative to directory, -1 if closed.
+        int handle() const
+        {
+            return descriptor;
+        }
+
+        /**Starts scanning from the first entry.
+        *Type filter supports the same values as entry type, 0 returns all entries.
+        */
+        void scan(unsigned short filter = 0)
+        {
+            #ifdef LIBFILESTREAM_POSIX
+            typeFilter = filter;
+            bufferPlace = bufferSize = 0;
+            scanEnd = false;
+            if(descriptor < 0)
+            {
+                return;
+            }
+            #if defined(__linux__)
+            buffer.resize(scanBufferSize);
+            lseek(descriptor, 0, SEEK_SET);
+            #else
+            if(reader == nullptr)
+            {
+                int duplicate = dup(descriptor);
+                reader = (duplicate >= 0)?(fdopendir(duplicate)):(nullptr);
+            }
+            if(reader != nullptr)
+            {
+                rewinddir(reader);
+            }
+            #endif
+            #else
+            (void)filter;
+            #endif
+        }
+
+        /**Returns next entry. Entries "." and ".." are skipped.
+        *Returns false at the end of directory or on error.
+        */
+        bool next(fileDirectoryEntry& entry)
+        {
+            if(descriptor < 0)
+            {
+                return false;
+            }
+            while(nextRaw(entry))
+            {
+                if(entry.name[0] == '.' and (entry.name[1] == '\0' or (entry.name[1] == '.' and entry.name[2] == '\0')))
+                {
+                    continue;
+                }
+                #ifdef LIBFILESTREAM_POSIX
+                if(entry.type == 0)
+                {
+                    entry.type = resolveType(entry.name);
+                }
+                #endif
+                if(typeFilter == 0 or entry.type == typeFilter)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        ///Closes directory.
+        void close()
+        {
+            #ifdef LIBFILESTREAM_POSIX
+            #if !defined(__linux__)
+            if(reader != nullptr)
+            {
+                closedir(reader);
+                reader = nullptr;
+            }
+            #endif
+            if(descriptor >= 0)
+            {
+                ::close(descriptor);
+            }
+            #endif
+            descriptor = -1;
+            privatePath.clear();
+            buffer.clear();
+            bufferPlace = bufferSize = 0;
+        }
+
+        ///Close directory automatically during destruction.
+        ~fileDirectory()
+        {
+            close();
+        }
+};
+
+/**
+ * Region of file containing data, as found by extent search of sparse files.
+ */
+struct fileExtent
+{
+    ///Place of the first byte of region.
+    std::uint64_t offset = 0;
+
+    ///Amount of bytes in region.
+    std::uint64_t length = 0;
+};
+
+/**
+ * Allocation hints given during opening of file stream.
+ */
+struct fileAllocation
+{
+    ///Expected final size of file in bytes. Storage for it is reserved during opening, 0 disables it.
+    std::uint64_t expectedSize = 0;
+};
+
+/**
+ * Settings of memory mapped file stream.
+ */
+struct fileMapping
+{
+    ///Whenever mapping is aligned to 2 MiB and transparent huge pages are requested for it.
+    bool hugePages = false;
+
+    ///Amount of bytes reserved for mapping during opening, so growing file doesn't need remapping, 0 maps only existing file. Until closing, file has size of the capacity.
+    std::uint64_t initialCapacity = 0;
+};
+
+/**
+ * State of memory mapped file stream.
+ * While writable stream is open, file is extended to capacity of mapping and cut to its real size during closing.
+ * Crash before closing leaves zero padding after real size, so capacity grows in steps of at most 64 MiB past initial capacity.
+ */
+struct fileMappingState
+{
+    ///Start of mapping, nullptr if nothing is mapped.
+    unsigned char* data = nullptr;
+
+    ///Amount of mapped bytes.
+    std::uint64_t capacity = 0;
+
+    ///Real size of file.
+    std::uint64_t size = 0;
+
+    ///Position of stream.
+    std::uint64_t position = 0;
+
+    fileMapping settings;
+
+    bool writable = false;
+
+    int descriptor = -1;
+
+    ///Size to which capacity is rounded.
+    std::uint64_t granularity() const
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        return (settings.hugePages)?(std::uint64_t(1) << 21):((std::uint64_t)sysconf(_SC_PAGESIZE));
+        #else
+        return 4096;
+        #endif
+    }
+
+    /**Maps file of choosen descriptor. Returns false and sets errno on failure.
+    *Syntax is following:
+    *state.open(descriptor, writable, settings);
+    */
+    bool open(int choosenDescriptor, bool isWritable, const fileMapping& choosenSettings)
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        descriptor = choosenDescriptor;
+        writable = isWritable;
+        settings = choosenSettings;
+        struct stat information;
+        if(fstat(descriptor, &information) != 0)
+        {
+            return false;
+        }
+        size = (std::uint64_t)information.st_size;
+        std::uint64_t wanted = (writable and settings.initialCapacity > size)?(settings.initialCapacity):(size);
+        return wanted == 0 or remap(wanted);
+        #else
+        (void)choosenDescriptor;
+        (void)isWritable;
+        (void)choosenSettings;
+        errno = ENOTSUP;
+        return false;
+        #endif
+    }
+
+    /**Maps at least choosen amount of bytes, extending file if needed. Returns false and sets errno on failure.
+    *Syntax is following:
+    *state.remap(bytes);
+    */
+    bool remap(std::uint64_t wanted)
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        std::uint64_t unit = granularity();
+        std::uint64_t newCapacity = (writable)?((wanted + unit - 1) / unit * unit):(wanted);
+        if(writable and ftruncate(descriptor, (off_t)newCapacity) != 0)
+        {
+            return false;
+        }
+        int protection = (writable)?(PROT_READ | PROT_WRITE):(PROT_READ);
+        void* mapped = MAP_FAILED;
+        #if defined(__linux__) && defined(_GNU_SOURCE)
+        if(data != nullptr and !settings.hugePages)
+        {
+            //Kernel can move or extend existing mapping without copying page tables again.
+            mapped = mremap(data, (size_t)capacity, (size_t)newCapacity, MREMAP_MAYMOVE);
+            if(mapped == MAP_FAILED)
+            {
+                return false;
+            }
+            data = static_cast<unsigned char*>(mapped);
+            capacity = newCapacity;
+            return true;
+        }
+        #endif
+        if(settings.hugePages)
+        {
+            //Reserve larger range, so aligned place inside of it can be used.
+            std::uint64_t alignment = granularity();
+            void* reserved = mmap(nullptr, (size_t)(newCapacity + alignment), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(reserved == MAP_FAILED)
+            {
+                return false;
+            }
+            std::uintptr_t start = ((std::uintptr_t)reserved + alignment - 1) / alignment * alignment;
+            mapped = mmap((void*)start, (size_t)newCapacity, protection, MAP_SHARED | MAP_FIXED, descriptor, 0);
+            if(mapped == MAP_FAILED)
+            {
+                munmap(reserved, (size_t)(newCapacity + alignment));
+                return false;
+            }
+            if(start > (std::uintptr_t)reserved)
+            {
+                munmap(reserved, start - (std::uintptr_t)reserved);
+            }
+            std::uintptr_t reservedEnd = (std::uintptr_t)reserved + (std::uintptr_t)(newCapacity + alignment);
+            if(reservedEnd > start + newCapacity)
+            {
+                munmap((void*)(start + newCapacity), reservedEnd - (start + newCapacity));
+            }
+            #ifdef MADV_HUGEPAGE
+            madvise(mapped, (size_t)newCapacity, MADV_HUGEPAGE);
+            #endif
+        }
+        else
+        {
+            mapped = mmap(nullptr, (size_t)newCapacity, protection, MAP_SHARED, descriptor, 0);
+            if(mapped == MAP_FAILED)
+            {
+                return false;
+            }
+        }
+        unmap();
+        data = static_cast<unsigned char*>(mapped);
+        capacity = newCapacity;
+        errno = 0; //Advice failures aren't errors.
+        return true;
+        #else
+        (void)wanted;
+        errno = ENOTSUP;
+        return false;
+        #endif
+    }
+
+    ///Largest growth of capacity, which limits padding left by crash.
+    const static std::uint64_t maximalGrowth = std::uint64_t(64) << 20;
+
+    ///Ensures that choosen place is mapped, growing mapping at least twice, but by at most maximal growth, to keep appending cheap.
+    bool ensure(std::uint64_t end)
+    {
+        if(end <= capacity)
+        {
+            return true;
+        }
+        if(!writable)
+        {
+            errno = EBADF;
+            return false;
+        }
+        std::uint64_t grown = capacity + ((capacity < maximalGrowth)?(capacity):(maximalGrowth));
+        return remap((end > grown)?(end):(grown));
+    }
+
+    ///Copies bytes into choosen place, growing file if needed. Returns false and sets errno on failure.
+    bool writeAt(std::uint64_t place, const void* source, size_t byteCount)
+    {
+        if(byteCount == 0)
+        {
+            return true;
+        }
+        if(!ensure(place + byteCount))
+        {
+            return false;
+        }
+        std::memcpy(data + place, source, byteCount);
+        size = (place + byteCount > size)?(place + byteCount):(size);
+        return true;
+    }
+
+    ///Copies whole elements from choosen place. Returns amount of copied elements.
+    size_t readAt(std::uint64_t place, void* target, size_t elementSize, size_t count) const
+    {
+        std::uint64_t available = (place < size)?((size - place) / elementSize):(0);
+        size_t copied = (available < count)?((size_t)available):(count);
+        if(copied != 0)
+        {
+            std::memcpy(target, data + place, copied * elementSize);
+        }
+        return copied;
+    }
+
+    /**Synchronizes choosen range of mapping with file.
+    *Synchronization supports one of the 2 values:
+    *1 - asynchronous, writeback is only started;
+    *2 - synchronous, waits until data is written.
+    */
+    bool synchronize(std::uint64_t offset, std::uint64_t length, unsigned short synchronization)
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        if(data == nullptr or offset >= capacity)
+        {
+            return true;
+        }
+        std::uint64_t page = (std::uint64_t)sysconf(_SC_PAGESIZE);
+        std::uint64_t start = offset / page * page;
+        std::uint64_t end = (length > capacity - offset)?(capacity):(offset + length);
+        return msync(data + start, (size_t)(end - start), (synchronization == 1)?(MS_ASYNC):(MS_SYNC)) == 0;
+        #else
+        (void)offset;
+        (void)length;
+        (void)synchronization;
+        errno = ENOTSUP;
+        return false;
+        #endif
+    }
+
+    ///Removes mapping.
+    void unmap()
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        if(data != nullptr)
+        {
+            munmap(data, (size_t)capacity);
+        }
+        #endif
+        data = nullptr;
+        capacity = 0;
+    }
+
+    ///Removes mapping and cuts file to its real size. Returns false and sets errno on failure.
+    bool close()
+    {
+        unmap();
+        #ifdef LIBFILESTREAM_POSIX
+        if(writable and ftruncate(descriptor, (off_t)size) != 0)
+        {
+            return false;
+        }
+        #endif
+        return true;
+    }
+};
+
+/**
+ * Settings of stream kept in memory.
+ * Stream is moved into spill file once it grows past spill threshold, so big temporary data doesn't stay in memory.
+ */
+struct fileMemory
+{
+    ///Size in bytes, past which stream is moved into spill file, 0 never moves it.
+    std::uint64_t spillThreshold = 0;
+
+    ///Path of spill file in UTF-8. It is created or truncated when stream is moved into it.
+    std::string spillPath;
+};
+
+/**
+ * State of stream kept in memory. Memory is an anonymous file, so C stream functions work on it and it can be given out as descriptor.
+ */
+struct fileMemoryState
+{
+    ///Descriptor of memory, kept for reopening. C stream uses its own duplicate.
+    int descriptor = -1;
+
+    std::uint64_t spillThreshold = 0;
+
+    std::string spillPath;
+
+    ///Creates empty memory. Returns false and sets errno on failure.
+    bool open()
+    {
+        #if defined(__linux__) && defined(SYS_memfd_create)
+        descriptor = (int)syscall(SYS_memfd_create, "libfilestream", 1u); //MFD_CLOEXEC
+        return descriptor != -1;
+        #elif defined(LIBFILESTREAM_POSIX)
+        //Shared memory object is unlinked right after creation, so it lives only while it is open.
+        static std::atomic<unsigned> counter{0};
+        std::string name = "/libfilestream-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+        descriptor = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if(descriptor == -1)
+        {
+            return false;
+        }
+        shm_unlink(name.c_str());
+        return true;
+        #else
+        errno = ENOTSUP;
+        return false;
+        #endif
+    }
+
+    ///Path under which memory can be opened by other functions while it is open.
+    std::string path() const
+    {
+        #if defined(__linux__)
+        return "/proc/self/fd/" + std::to_string(descriptor);
+        #else
+        return "/dev/fd/" + std::to_string(descriptor);
+        #endif
+    }
+
+    /**Gives new C stream of memory with choosen mode string. Modes 2 and 5 truncate memory, as opening file would do.
+    *Returns nullptr and sets errno on failure.
+    */
+    FILE* stream(unsigned short openingMode, const char* modeString)
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        if((openingMode == 2 or openingMode == 5) and ftruncate(descriptor, 0) != 0)
+        {
+            return nullptr;
+        }
+        int duplicate = dup(descriptor);
+        if(duplicate == -1)
+        {
+            return nullptr;
+        }
+        //Duplicates share flags and position, so appending and position of previous stream mustn't stay.
+        lseek(duplicate, 0, SEEK_SET);
+        int flags = fcntl(duplicate, F_GETFL);
+        if(flags != -1 and openingMode != 3 and openingMode != 6)
+        {
+            fcntl(duplicate, F_SETFL, flags & ~O_APPEND);
+        }
+        FILE* opened = fdopen(duplicate, modeString);
+        if(opened == nullptr)
+        {
+            ::close(duplicate);
+        }
+        return opened;
+        #else
+        (void)openingMode;
+        (void)modeString;
+        errno = ENOTSUP;
+        return nullptr;
+        #endif
+    }
+
+    void close()
+    {
+        #ifdef LIBFILESTREAM_POSIX
+        if(descriptor != -1)
+        {
+            ::close(descriptor);
+        }
+        #endif
+        descriptor = -1;
+    }
+};
+
+/**
+ * Settings of checksum updated by binary reading and writing.
+ * Algorithm supports one of the 3 values:
+ * 1 - CRC32C, uses SSE4.2 or ARMv8 CRC instructions where processor has them;
+ * 2 - xxHash64;
+ * 3 - user supplied digest, updated by update function and finished by finish function.
+ */
+struct fileChecksum
+{
+    ///Used algorithm.
+    unsigned short algorithm = 1;
+
+    ///Seed of xxHash64.
+    std::uint64_t seed = 0;
+
+    ///Updates user supplied digest with choosen bytes.
+    void (*update)(void* context, const void* data, size_t byteCount) = nullptr;
+
+    ///Returns user supplied digest of all bytes so far, without changing its state.
+    std::uint64_t (*finish)(void* context) = nullptr;
+
+    ///Pointer given to update and finish.
+    void* context = nullptr;
+};
+
+/**
+ * State of checksum updated by binary reading and writing.
+ */
+struct fileChecksumState
+{
+    fileChecksum settings;
+
+    std::uint32_t crc = 0;
+
+    //xxHash64 storage.
+    std::uint64_t accumulators[4] = {};
+    std::uint64_t totalLength = 0;
+    unsigned char pending[32] = {};
+    size_t pendingSize = 0;
+
+    const static std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    const static std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    const static std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+    const static std::uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    const static std::uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+    ///Starts checksum again.
+    void reset()
+    {
+        crc = 0;
+        accumulators[0] = settings.seed + prime1 + prime2;
+        accumulators[1] = settings.seed + prime2;
+        accumulators[2] = settings.seed;
+        accumulators[3] = settings.seed - prime1;
+        totalLength = 0;
+        pendingSize = 0;
+    }
+
+    static std::uint64_t rotate(std::uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static std::uint64_t load64(const unsigned char* data)
+    {
+        std::uint64_t value;
+        std::memcpy(&value, data, 8);
+        return (fileByteOrder::native == fileByteOrder::little)?(value):(fileByteOrder::swap(value));
+    }
+
+    static std::uint32_t load32(const unsigned char* data)
+    {
+        std::uint32_t value;
+        std::memcpy(&value, data, 4);
+        return (fileByteOrder::native == fileByteOrder::little)?(value):(fileByteOrder::swap(value));
+    }
+
+    static std::uint64_t round(std::uint64_t accumulator, std::uint64_t input)
+    {
+        return rotate(accumulator + input * prime2, 31) * prime1;
+    }
+
+    static std::uint64_t merge(std::uint64_t hash, std::uint64_t accumulator)
+    {
+        return (hash ^ round(0, accumulator)) * prime1 + prime4;
+    }
+
+    ///Table of software CRC32C, processing 8 bytes at once.
+    static const std::uint32_t* crcTable()
+    {
+        static std::uint32_t table[8][256];
+        static bool ready = [&]()
+        {
+            for(std::uint32_t i = 0; i < 256; ++i)
+            {
+                std::uint32_t value = i;
+                for(int bit = 0; bit < 8; ++bit)
+                {
+                    value = (value >> 1) ^ ((value & 1)?(0x82F63B78U):(0));
+                }
+                table[0][i] = value;
+            }
+            for(std::uint32_t i = 0; i < 256; ++i)
+            {
+                for(int slice = 1; slice < 8; ++slice)
+                {
+                    table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+                }
+            }
+            return true;
+        }();
+        (void)ready;
+        return &table[0][0];
+    }
+
+    static std::uint32_t crcSoftware(std::uint32_t value, const unsigned char* data, size_t byteCount)
+    {
+        const std::uint32_t* table = crcTable();
+        for(; byteCount >= 8; data += 8, byteCount -= 8)
+        {
+            std::uint32_t low = load32(data) ^ value, high = load32(data + 4);
+            value = table[7 * 256 + (low & 0xFF)] ^ table[6 * 256 + ((low >> 8) & 0xFF)] ^ table[5 * 256 + ((low >> 16) & 0xFF)] ^ table[4 * 256 + (low >> 24)]
+                ^ table[3 * 256 + (high & 0xFF)] ^ table[2 * 256 + ((high >> 8) & 0xFF)] ^ table[1 * 256 + ((high >> 16) & 0xFF)] ^ table[high >> 24];
+        }
+        for(; byteCount > 0; ++data, --byteCount)
+        {
+            value = (value >> 8) ^ table[(value ^ *data) & 0xFF];
+        }
+        return value;
+    }
+
+    #if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    __attribute__((target("sse4.2")))
+    static std::uint32_t crcHardware(std::uint32_t value, const unsigned char* data, size_t byteCount)
+    {
+        std::uint64_t wide = value;
+        for(; byteCount >= 8; data += 8, byteCount -= 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data, 8);
+            wide = _mm_crc32_u64(wide, word);
+        }
+        value = (std::uint32_t)wide;
+        for(; byteCount > 0; ++data, --byteCount)
+        {
+            value = _mm_crc32_u8(value, *data);
+        }
+        return value;
+    }
+
+    static bool hasHardwareCrc()
+    {
+        static bool supported = __builtin_cpu_supports("sse4.2");
+        return supported;
+    }
+    #elif defined(__ARM_FEATURE_CRC32)
+    static std::uint32_t crcHardware(std::uint32_t value, const unsigned char* data, size_t byteCount)
+    {
+        for(; byteCount >= 8; data += 8, byteCount -= 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data, 8);
+            value = __crc32cd(value, word);
+        }
+        for(; byteCount > 0; ++data, --byteCount)
+        {
+            value = __crc32cb(value, *data);
+        }
+        return value;
+    }
+
+    static bool hasHardwareCrc()
+    {
+        return true;
+    }
+    #else
+    static std::uint32_t crcHardware(std::uint32_t value, const unsigned char* data, size_t byteCount)
+    {
+        return crcSoftware(value, data, byteCount);
+    }
+
+    static bool hasHardwareCrc()
+    {
+        return false;
+    }
+    #endif
+
+    ///Processes full 32 byte stripes of xxHash64.
+    void stripes(const unsigned char* data, size_t count)
+    {
+        for(size_t i = 0; i < count; ++i, data += 32)
+        {
+            accumulators[0] = round(accumulators[0], load64(data));
+            accumulators[1] = round(accumulators[1], load64(data + 8));
+            accumulators[2] = round(accumulators[2], load64(data + 16));
+            accumulators[3] = round(accumulators[3], load64(data + 24));
+        }
+    }
+
+    ///Updates checksum with choosen bytes.
+    void update(const void* data, size_t byteCount)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        switch(settings.algorithm)
+        {
+            case 1:
+            {
+                crc = ~((hasHardwareCrc())?(crcHardware(~crc, bytes, byteCount)):(crcSoftware(~crc, bytes, byteCount)));
+                return;
+            }
+            case 2:
+            {
+                totalLength += byteCount;
+                if(pendingSize + byteCount < 32)
+                {
+                    std::memcpy(pending + pendingSize, bytes, byteCount);
+                    pendingSize += byteCount;
+                    return;
+                }
+                if(pendingSize != 0)
+                {
+                    size_t part = 32 - pendingSize;
+                    std::memcpy(pending + pendingSize, bytes, part);
+                    stripes(pending, 1);
+                    bytes += part;
+                    byteCount -= part;
+                    pendingSize = 0;
+                }
+                stripes(bytes, byteCount / 32);
+                std::memcpy(pending, bytes + byteCount / 32 * 32, byteCount % 32);
+                pendingSize = byteCount % 32;
+                return;
+            }
+            case 3:
+            {
+                settings.update(settings.context, data, byteCount);
+                return;
+            }
+        }
+    }
+
+    ///Returns checksum of all bytes so far. State isn't changed, so updating can continue.
+    std::uint64_t digest() const
+    {
+        switch(settings.algorithm)
+        {
+            case 1:
+            {
+                return crc;
+            }
+            case 2:
+            {
+                std::uint64_t hash;
+                if(totalLength >= 32)
+                {
+                    hash = rotate(accumulators[0], 1) + rotate(accumulators[1], 7) + rotate(accumulators[2], 12) + rotate(accumulators[3], 18);
+                    for(const std::uint64_t& accumulator : accumulators)
+                    {
+                        hash = merge(hash, accumulator);
+                    }
+                }
+                else
+                {
+                    hash = settings.seed + prime5;
+                }
+                hash += totalLength;
+                size_t place = 0;
+                for(; place + 8 <= pendingSize; place += 8)
+                {
+                    hash = rotate(hash ^ round(0, load64(pending + place)), 27) * prime1 + prime4;
+                }
+                if(place + 4 <= pendingSize)
+                {
+                    hash = rotate(hash ^ (load32(pending + place) * prime1), 23) * prime2 + prime3;
+                    place += 4;
+                }
+                for(; place < pendingSize; ++place)
+                {
+                    hash = rotate(hash ^ (pending[place] * prime5), 11) * prime1;
+                }
+                hash ^= hash >> 33;
+                hash *= prime2;
+                hash ^= hash >> 29;
+                hash *= prime3;
+                hash ^= hash >> 32;
+                return hash;
+            }
+            case 3:
+            {
+                return settings.finish(settings.context);
+            }
+        }
+        return 0;
+    }
+};
+
+/**
+ * Text encoding layer of file stream.
+ * Encoding supports one of the 5 values:
+ * 1 - UTF-8;
+ * 2 - UTF-16 little endian;
+ * 3 - UTF-16 big endian;
+ * 4 - UTF-32 little endian;
+ * 5 - UTF-32 big endian.
+ * Text is read in large blocks and transcoded into characters of requested type: char receives UTF-8, char16_t UTF-16 and char32_t UTF-32.
+ * UTF-8 runs of ASCII and 2 byte sequences are validated and transcoded with SSE2, runs of 3 byte sequences with SSSE3. Mixed runs and 4 byte sequences go one code point at a time.
+ */
+struct fileEncodingState
+{
+    ///Used encoding.
+    unsigned short encoding = 1;
+
+    //Read buffer storage.
+    std::vector<unsigned char> raw;
+    size_t rawPlace = 0;
+    size_t rawSize = 0;
+    bool sourceEnd = false;
+
+    ///Code units of last code point not returned yet by character reading.
+    std::vector<char32_t> pendingUnits;
+    size_t pendingPlace = 0;
+
+    ///Size of read buffer.
+    const static size_t rawBufferSize = 1 << 16;
+
+    ///Checks whenever encoding is one of the supported values.
+    static bool isValid(unsigned short encoding)
+    {
+        return encoding >= 1 and encoding <= 5;
+    }
+
+    ///Detects encoding from byte order mark. Returns 0 if there is no mark, otherwise sets its length.
+    static unsigned short detect(const unsigned char* data, size_t size, size_t& markSize)
+    {
+        if(size >= 4 and data[0] == 0xFF and data[1] == 0xFE and data[2] == 0 and data[3] == 0)
+        {
+            markSize = 4;
+            return 4;
+        }
+        if(size >= 4 and data[0] == 0 and data[1] == 0 and data[2] == 0xFE and data[3] == 0xFF)
+        {
+            markSize = 4;
+            return 5;
+        }
+        if(size >= 3 and data[0] == 0xEF and data[1] == 0xBB and data[2] == 0xBF)
+        {
+            markSize = 3;
+            return 1;
+        }
+        if(size >= 2 and data[0] == 0xFF and data[1] == 0xFE)
+        {
+            markSize = 2;
+            return 2;
+        }
+        if(size >= 2 and data[0] == 0xFE and data[1] == 0xFF)
+        {
+            markSize = 2;
+            return 3;
+        }
+        markSize = 0;
+        return 0;
+    }
+
+    ///Returns length of ASCII prefix, checking 16 bytes at once with SSE2.
+    static size_t asciiPrefix(const unsigned char* data, size_t size)
+    {
+        size_t place = 0;
+        #if defined(__SSE2__)
+        for(; place + 16 <= size; place += 16)
+        {
+            unsigned mask = (unsigned)_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + place)));
+            if(mask != 0)
+            {
+                return place + (size_t)__builtin_ctz(mask);
+            }
+        }
+        #endif
+        while(place < size and data[place] < 0x80)
+        {
+            ++place;
+        }
+        return place;
+    }
+
+    ///Appends ASCII bytes as characters of choosen type, widening 16 bytes at once with SSE2.
+    template<class char_type, class container>
+    static void appendAscii(const unsigned char* data, size_t size, container& out)
+    {
+        size_t start = out.size();
+        out.resize(start + size);
+        char_type* target = out.data() + start;
+        size_t place = 0;
+        #if defined(__SSE2__)
+        if constexpr(sizeof(char_type) == 2 or sizeof(char_type) == 4)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            for(; place + 16 <= size; place += 16)
+            {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + place));
+                __m128i low = _mm_unpacklo_epi8(bytes, zero), high = _mm_unpackhi_epi8(bytes, zero);
+                if constexpr(sizeof(char_type) == 2)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + place), low);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + place + 8), high);
+                }
+                else
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + place), _mm_unpacklo_epi16(low, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + place + 4), _mm_unpackhi_epi16(low, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + place + 8), _mm_unpacklo_epi16(high, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + place + 12), _mm_unpackhi_epi16(high, zero));
+                }
+            }
+        }
+        #endif
+        for(; place < size; ++place)
+        {
+            target[place] = (char_type)data[place];
+        }
+    }
+
+    /**Validates and transcodes UTF-8 blocks of 8 two byte sequences or 4 three byte sequences with vector instructions.
+    *Stops at the first block not made of one of them or after limit code points. Returns amount of used bytes.
+    */
+    template<class char_type, class container>
+    static size_t appendMultiByte(const unsigned char* data, size_t size, size_t& limit, container& out)
+    {
+        size_t place = 0;
+        #if defined(__SSE2__)
+        //Output grows in steps bounded by remaining input and is cut to written size at the end, so most blocks are stored without resizing.
+        size_t start = out.size(), written = 0;
+        while(place + 16 <= size)
+        {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + place));
+            //Every 16 bit lane is lead byte 0xC2 to 0xDF followed by continuation byte, lead bytes 0xC0 and 0xC1 would be overlong.
+            __m128i pattern = _mm_cmpeq_epi16(_mm_and_si128(bytes, _mm_set1_epi16((short)0xC0E0)), _mm_set1_epi16((short)0x80C0));
+            __m128i overlong = _mm_cmpeq_epi16(_mm_and_si128(bytes, _mm_set1_epi16(0x1E)), _mm_setzero_si128());
+            if(limit >= 8 and _mm_movemask_epi8(_mm_andnot_si128(overlong, pattern)) == 0xFFFF)
+            {
+                __m128i points = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(bytes, _mm_set1_epi16(0x1F)), 6), _mm_and_si128(_mm_srli_epi16(bytes, 8), _mm_set1_epi16(0x3F)));
+                if(out.size() < start + written + 16)
+                {
+                    out.resize(start + written + 16 + std::min<size_t>(size - place, 4096));
+                }
+                char_type* target = out.data() + start + written;
+                if constexpr(sizeof(char_type) == 1)
+                {
+                    std::memcpy(target, data + place, 16);
+                    written += 16;
+                }
+                else if constexpr(sizeof(char_type) == 2)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target), points);
+                    written += 8;
+                }
+                else
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_unpacklo_epi16(points, _mm_setzero_si128()));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 4), _mm_unpackhi_epi16(points, _mm_setzero_si128()));
+                    written += 8;
+                }
+                place += 16;
+                limit -= 8;
+                continue;
+            }
+            #if defined(__SSSE3__)
+            //First 12 bytes are spread into 32 bit lanes, each lane must be lead byte 0xE0 to 0xEF followed by 2 continuation bytes.
+            __m128i lanes = _mm_shuffle_epi8(bytes, _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1));
+            pattern = _mm_cmpeq_epi32(_mm_and_si128(lanes, _mm_set1_epi32(0xC0C0F0)), _mm_set1_epi32(0x8080E0));
+            __m128i points = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(lanes, _mm_set1_epi32(0x0F)), 12), _mm_and_si128(_mm_srli_epi32(lanes, 2), _mm_set1_epi32(0xFC0))), _mm_and_si128(_mm_srli_epi32(lanes, 16), _mm_set1_epi32(0x3F)));
+            //Reject overlong forms and surrogates.
+            __m128i allowed = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(points, _mm_set1_epi32(0xF800)), _mm_set1_epi32(0xD800)), _mm_cmpgt_epi32(points, _mm_set1_epi32(0x7FF)));
+            if(limit >= 4 and _mm_movemask_epi8(_mm_and_si128(pattern, allowed)) == 0xFFFF)
+            {
+                if(out.size() < start + written + 16)
+                {
+                    out.resize(start + written + 16 + std::min<size_t>(size - place, 4096));
+                }
+                char_type* target = out.data() + start + written;
+                if constexpr(sizeof(char_type) == 1)
+                {
+                    std::memcpy(target, data + place, 12);
+                    written += 12;
+                }
+                else if constexpr(sizeof(char_type) == 2)
+                {
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(target), _mm_shuffle_epi8(points, _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1)));
+                    written += 4;
+                }
+                else
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(target), points);
+                    written += 4;
+                }
+                place += 12;
+                limit -= 4;
+                continue;
+            }
+            #endif
+            break;
+        }
+        out.resize(start + written);
+        #else
+        (void)data;
+        (void)size;
+        (void)limit;
+        (void)out;
+        #endif
+        return place;
+    }
+
+    ///Reads code unit of choosen size and byte order.
+    static std::uint32_t unit(const unsigned char* data, size_t size, bool bigEndian)
+    {
+        std::uint32_t value = 0;
+        for(size_t i = 0; i < size; ++i)
+        {
+            value |= (std::uint32_t)data[(bigEndian)?(i):(size - 1 - i)] << (8 * (size - 1 - i));
+        }
+        return value;
+    }
+
+    ///Decodes code point. Returns its length in bytes, 0 if sequence is incomplete or -1 if it is invalid.
+    static int decodePoint(const unsigned char* data, size_t size, unsigned short encoding, char32_t& point)
+    {
+        if(encoding == 1)
+        {
+            unsigned char first = data[0];
+            int length = (first < 0x80)?(1):((first >= 0xC2 and first < 0xE0)?(2):((first >= 0xE0 and first < 0xF0)?(3):((first >= 0xF0 and first < 0xF5)?(4):(-1))));
+            if(length < 0)
+            {
+                return -1;
+            }
+            if((size_t)length > size)
+            {
+                //Invalid continuation is reported even before the rest arrives.
+                for(size_t i = 1; i < size; ++i)
+                {
+                    if((data[i] & 0xC0) != 0x80)
+                    {
+                        return -1;
+                    }
+                }
+                return 0;
+            }
+            std::uint32_t value = (length == 1)?(first):(first & (0x7F >> length));
+            for(int i = 1; i < length; ++i)
+            {
+                if((data[i] & 0xC0) != 0x80)
+                {
+                    return -1;
+                }
+                value = (value << 6) | (data[i] & 0x3F);
+            }
+            //Reject overlong forms, surrogates and values after the last code point.
+            const std::uint32_t minimal[] = {0, 0, 0x80, 0x800, 0x10000};
+            if(value < minimal[length] or value > 0x10FFFF or (value >= 0xD800 and value <= 0xDFFF))
+            {
+                return -1;
+            }
+            point = value;
+            return length;
+        }
+        bool bigEndian = encoding == 3 or encoding == 5;
+        if(encoding == 4 or encoding == 5)
+        {
+            if(size < 4)
+            {
+                return 0;
+            }
+            std::uint32_t value = unit(data, 4, bigEndian);
+            if(value > 0x10FFFF or (value >= 0xD800 and value <= 0xDFFF))
+            {
+                return -1;
+            }
+            point = value;
+            return 4;
+        }
+        if(size < 2)
+        {
+            return 0;
+        }
+        std::uint32_t first = unit(data, 2, bigEndian);
+        if(first < 0xD800 or first > 0xDFFF)
+        {
+            point = first;
+            return 2;
+        }
+        if(first >= 0xDC00)
+        {
+            return -1;
+        }
+        if(size < 4)
+        {
+            return 0;
+        }
+        std::uint32_t second = unit(data + 2, 2, bigEndian);
+        if(second < 0xDC00 or second > 0xDFFF)
+        {
+            return -1;
+        }
+        point = 0x10000 + ((first - 0xD800) << 10) + (second - 0xDC00);
+        return 4;
+    }
+
+    ///Appends code point as characters of choosen type.
+    template<class char_type, class container>
+    static void encodePoint(char32_t point, container& out)
+    {
+        if constexpr(sizeof(char_type) == 1)
+        {
+            if(point < 0x80)
+            {
+                out.push_back((char_type)point);
+            }
+            else if(point < 0x800)
+            {
+                out.push_back((char_type)(0xC0 | (point >> 6)));
+                out.push_back((char_type)(0x80 | (point & 0x3F)));
+            }
+            else if(point < 0x10000)
+            {
+                out.push_back((char_type)(0xE0 | (point >> 12)));
+                out.push_back((char_type)(0x80 | ((point >> 6) & 0x3F)));
+                out.push_back((char_type)(0x80 | (point & 0x3F)));
+            }
+            else
+            {
+                out.push_back((char_type)(0xF0 | (point >> 18)));
+                out.push_back((char_type)(0x80 | ((point >> 12) & 0x3F)));
+                out.push_back((char_type)(0x80 | ((point >> 6) & 0x3F)));
+                out.push_back((char_type)(0x80 | (point & 0x3F)));
+            }
+        }
+        else if constexpr(sizeof(char_type) == 2)
+        {
+            if(point >= 0x10000)
+            {
+                out.push_back((char_type)(0xD800 + ((point - 0x10000) >> 10)));
+                out.push_back((char_type)(0xDC00 + ((point - 0x10000) & 0x3FF)));
+                return;
+            }
+            out.push_back((char_type)point);
+        }
+        else
+        {
+            out.push_back((char_type)point);
+        }
+    }
+
+    /**Transcodes bytes into characters of choosen type. Stops after limit code points, or after new line if stopAtNewLine is true. New line isn't added.
+    *Sets consumed to amount of used bytes, incomplete sequence at the end is left. Returns false on invalid data.
+    */
+    template<class char_type, class container>
+    bool transcode(const unsigned char* data, size_t size, container& out, size_t& consumed, size_t& limit, bool stopAtNewLine, bool& foundNewLine) const
+    {
+        size_t place = 0;
+        foundNewLine = false;
+        while(place < size and limit > 0)
+        {
+            if(encoding == 1)
+            {
+                //ASCII runs are copied without decoding every byte.
+                size_t run = asciiPrefix(data + place, size - place);
+                run = (run < limit)?(run):(limit);
+                if(stopAtNewLine and run != 0)
+                {
+                    const void* newLine = std::memchr(data + place, '\n', run);
+                    if(newLine != nullptr)
+                    {
+                        size_t length = (size_t)(static_cast<const unsigned char*>(newLine) - (data + place));
+                        appendAscii<char_type>(data + place, length, out);
+                        place += length + 1;
+                        limit -= length + 1;
+                        foundNewLine = true;
+                        break;
+                    }
+                }
+                if(run != 0)
+                {
+                    appendAscii<char_type>(data + place, run, out);
+                    place += run;
+                    limit -= run;
+                    continue;
+                }
+                //Runs of non-ASCII text have no new line to look for.
+                size_t used = appendMultiByte<char_type>(data + place, size - place, limit, out);
+                if(used != 0)
+                {
+                    place += used;
+                    continue;
+                }
+            }
+            char32_t point = 0;
+            int length = decodePoint(data + place, size - place, encoding, point);
+            if(length == 0)
+            {
+                break;
+            }
+            if(length < 0)
+            {
+                consumed = place;
+                return false;
+            }
+            place += (size_t)length;
+            --limit;
+            if(stopAtNewLine and point == '\n')
+            {
+                foundNewLine = true;
+                break;
+            }
+            encodePoint<char_type>(point, out);
+        }
+        consumed = place;
+        return true;
+    }
+
+    /**Encodes characters of choosen type into bytes of used encoding, appending them to out.
+    *Characters of char are treated as UTF-8, of 2 bytes as UTF-16 and of 4 bytes as UTF-32. Returns false on invalid characters.
+    */
+    template<class char_type>
+    bool encodeText(const char_type* text, size_t length, std::vector<unsigned char>& out) const
+    {
+        size_t place = 0;
+        while(place < length)
+        {
+            char32_t point = 0;
+            if constexpr(sizeof(char_type) == 1)
+            {
+                size_t run = asciiPrefix(reinterpret_cast<const unsigned char*>(text) + place, length - place);
+                if(encoding == 1 and run != 0)
+                {
+                    out.insert(out.end(), reinterpret_cast<const unsigned char*>(text) + place, reinterpret_cast<const unsigned char*>(text) + place + run);
+                    place += run;
+                    continue;
+                }
+                int used = decodePoint(reinterpret_cast<const unsigned char*>(text) + place, length - place, 1, point);
+                if(used <= 0)
+                {
+                    return false;
+                }
+                place += (size_t)used;
+            }
+            else if constexpr(sizeof(char_type) == 2)
+            {
+                std::uint32_t first = (std::uint16_t)text[place++];
+                if(first >= 0xD800 and first <= 0xDFFF)
+                {
+                    std::uint32_t second = (place < length)?((std::uint16_t)text[place]):(0);
+                    if(first >= 0xDC00 or second < 0xDC00 or second > 0xDFFF)
+                    {
+                        return false;
+                    }
+                    ++place;
+                    first = 0x10000 + ((first - 0xD800) << 10) + (second - 0xDC00);
+                }
+                point = first;
+            }
+            else
+            {
+                point = (char32_t)text[place++];
+                if(point > 0x10FFFF or (point >= 0xD800 and point <= 0xDFFF))
+                {
+                    return false;
+                }
+            }
+            if(encoding == 1)
+            {
+                encodePoint<char>(point, out);
+                continue;
+            }
+            std::uint32_t units[2] = {point, 0};
+            size_t count = 1;
+            if((encoding == 2 or encoding == 3) and point >= 0x10000)
+            {
+                units[0] = 0xD800 + ((point - 0x10000) >> 10);
+                units[1] = 0xDC00 + ((point - 0x10000) & 0x3FF);
+                count = 2;
+            }
+            size_t width = (encoding <= 3)?(2):(4);
+            bool bigEndian = encoding == 3 or encoding == 5;
+            for(size_t j = 0; j < count; ++j)
+            {
+                for(size_t i = 0; i < width; ++i)
+                {
+                    out.push_back((unsigned char)(units[j] >> (8 * ((bigEndian)?(width - 1 - i):(i)))));
+                }
+            }
+        }
+        return true;
+    }
+
+    ///Moves unused bytes to the start of buffer and reads more. Returns false on error.
+    bool fill(FILE* file)
+    {
+        if(rawPlace > 0)
+        {
+            std::memmove(raw.data(), raw.data() + rawPlace, rawSize - rawPlace);
+            rawSize -= rawPlace;
+            rawPlace = 0;
+        }
+        raw.resize(rawBufferSize);
+        size_t result = fread(raw.data() + rawSize, 1, raw.size() - rawSize, file);
+        rawSize += result;
+        sourceEnd = result < raw.size() - (rawSize - result);
+        return ferror(file) == 0;
+    }
+
+    ///Amount of read bytes not transcoded yet.
+    size_t unused() const
+    {
+        return rawSize - rawPlace;
+    }
+};
+
+/**
+ * Structure representing file stream.
+ * Places own data safety at first place.
+ * Use open to open file and close to close it.
+ * Every file stream has defined constants mode, binary, path, end, error.
+ */
+template<class path_type = char>
+struct fileStream
+{
+    protected:
+        //Secure storage, inaccessible from outside.
+
+        ///File storage.
+        FILE* file = nullptr;
+
+        ///Mode storage.
+        unsigned short privateMode = 0;
+
+        ///Binary mode storage;
+        unsigned short privateBinaryMode = false;
+
+        ///Error storage.
+        int privateError = 0;
+
+        ///Amount of path characters stored inside of stream without allocation.
+        const static size_t inlinePathSize = 128 / sizeof(path_type);
+
+        ///Current path storage.
+        path_type* privatePath = nullptr;
+
+        ///Storage of short paths. Typical paths fit into it, so opening doesn't allocate.
+        path_type privateInlinePath[inlinePathSize] = {};
+
+        bool privateEndOfFile = false;
+
+        ///Compressed stream state, nullptr if stream is not compressed.
+        fileCompressionState* privateCompression = nullptr;
+
+        ///Line index, nullptr if not built or loaded.
+        fileLineIndex* privateLineIndex = nullptr;
+
+        ///Atomic writing state, nullptr if stream writes directly into its file.
+        fileAtomicState* privateAtomic = nullptr;
+
+        ///Memory mapping state, nullptr if stream uses C stream functions.
+        fileMappingState* privateMapping = nullptr;
+
+        ///Checksum updated by binary reading and writing, nullptr if not used.
+        fileChecksumState* privateChecksum = nullptr;
+
+        ///Text encoding layer, nullptr if text is read and written byte by byte.
+        fileEncodingState* privateEncoding = nullptr;
+
+        ///Memory of stream kept in memory, nullptr if stream has a file.
+        fileMemoryState* privateMemory = nullptr;
+
+        ///Memory resource of returned buffers and path, nullptr if new[] and delete[] are used.
+        std::pmr::memory_resource* privateResource = nullptr;
+
+        ///Own monotonic arena, nullptr if not used.
+        std::pmr::monotonic_buffer_resource* privateArena = nullptr;
+    
+    private:
+        //Secure secret functions storage.
+
+        //Functions from other libraries.
+
+        //Checks whenever it contains zero given its real or expected size.
+        template<class char_type = char>
+        static bool isStringZeroTerminated(const char_type* const& string, size_t expectedSize = 0)
+        {
+            for(size_t i = 0; i < expectedSize; ++i)
+            {
+                if(string[i] == '\0')
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //Protects from "(Function name) doesn't handle strings that are not '\0'-terminated; if given one it may perform an over-read (it could cause a crash if unprotected) (CWE-126)."
+        template<class char_type = char>
+        static void ensureZeroTerminated(char_type* string, size_t expectedSize = 0)
+        {
+            if(not isStringZeroTerminated<char_type>(string, expectedSize))
+            {
+                string[expectedSize - 1] = '\0';
+            }
+        }
+
+        ///Copy list into another list.
+        template<class type>
+        static void copyList(const type copiedlist[], type list[], size_t size)
+        {
+            for(size_t i = 0; i < size; ++i)
+            {
+                list[i] = copiedlist[i];
+            }
+        }
+
+        ///Returns length of the string.
+        template<class type>
+        static size_t stringLength(const type* const& string)
+        {
+            //for(size_t i = 0; string[i] != '\0'; ++i)
+            size_t i = 0;
+            while(string[i] != '\0')
+            {
+                ++i;
+            }
+            return i;
+        }
+
+        ///Returns memory resource used for temporary storage.
+        std::pmr::memory_resource* currentResource() const
+        {
+            return (privateResource != nullptr)?(privateResource):(std::pmr::new_delete_resource());
+        }
+
+        ///Allocates array from choosen memory resource, or with new[] if none choosen.
+        template<class type>
+        type* allocate(size_t count)
+        {
+            if(privateResource == nullptr)
+            {
+                return new type[count];
+            }
+            type* array = static_cast<type*>(privateResource->allocate(sizeof(type) * count, alignof(type)));
+            std::uninitialized_default_construct_n(array, count);
+            return array;
+        }
+
+        ///Frees array allocated by allocate.
+        template<class type>
+        void deallocate(type* array, size_t count)
+        {
+            if(array == nullptr)
+            {
+                return;
+            }
+            if(privateResource == nullptr)
+            {
+                delete[] array;
+                return;
+            }
+            std::destroy_n(array, count);
+            privateResource->deallocate(array, sizeof(type) * count, alignof(type));
+        }
+
+        ///Returns string with collected characters, allocated with exact size.
+        template<class type>
+        type* finishString(const std::pmr::vector<type>& characters)
+        {
+            type* newString = allocate<type>(characters.size() + 1);
+            copyList<type>(characters.data(), newString, characters.size());
+            newString[characters.size()] = '\0';
+            return newString;
+        }
+
+        ///Returns empty string reported by failed reading. It is allocated as every other returned string, so it is freed by release and isn't shared.
+        template<class type>
+        type* emptyString()
+        {
+            type* empty = allocate<type>(1);
+            empty[0] = type();
+            return empty;
+        }
+
+        ///Longest accepted path. Since no legal path bigger than this constant exists, longer strings are rejected.
+        const static size_t maximalPathLength = PATH_MAX / (sizeof(path_type) * 8);
+
+        ///Finds length of path in single pass. Returns false if path is too long or isn't zero terminated.
+        static bool pathLength(const path_type* const& string, size_t& length)
+        {
+            for(length = 0; length < maximalPathLength; ++length)
+            {
+                if(string[length] == '\0')
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        ///Stores copy of path, inside of stream if it is short enough.
+        void storePath(const path_type* string, size_t length)
+        {
+            privatePath = (length < inlinePathSize)?(privateInlinePath):(allocate<path_type>(length + 1));
+            copyList<path_type>(string, privatePath, length);
+            privatePath[length] = '\0';
+        }
+
+        ///Frees stored path.
+        void releasePath()
+        {
+            if(privatePath != nullptr and privatePath != privateInlinePath)
+            {
+                deallocate(privatePath, stringLength(privatePath) + 1);
+            }
+            privatePath = nullptr;
+        }
+
+        /**Converts path into UTF-8 for C functions. Paths of wide characters are treated as UTF-16 or UTF-32 according to character size.
+        *Returns false if path isn't valid.
+        */
+        static bool encodePath(const path_type* string, std::string& converted)
+        {
+            converted.clear();
+            for(size_t i = 0; string[i] != '\0'; ++i)
+            {
+                std::uint32_t point = (std::uint32_t)string[i];
+                if constexpr(sizeof(path_type) == 2)
+                {
+                    point &= 0xFFFF;
+                    if(point >= 0xD800 and point <= 0xDBFF)
+                    {
+                        std::uint32_t low = (std::uint32_t)string[i + 1] & 0xFFFF;
+                        if(low < 0xDC00 or low > 0xDFFF)
+                        {
+                            return false;
+                        }
+                        point = 0x10000 + ((point - 0xD800) << 10) + (low - 0xDC00);
+                        ++i;
+                    }
+                    else if(point >= 0xDC00 and point <= 0xDFFF)
+                    {
+                        return false;
+                    }
+                }
+                if(point < 0x80)
+                {
+                    converted.push_back((char)point);
+                }
+                else if(point < 0x800)
+                {
+                    converted.push_back((char)(0xC0 | (point >> 6)));
+                    converted.push_back((char)(0x80 | (point & 0x3F)));
+                }
+                else if(point < 0x10000)
+                {
+                    if(point >= 0xD800 and point <= 0xDFFF)
+                    {
+                        return false;
+                    }
+                    converted.push_back((char)(0xE0 | (point >> 12)));
+                    converted.push_back((char)(0x80 | ((point >> 6) & 0x3F)));
+                    converted.push_back((char)(0x80 | (point & 0x3F)));
+                }
+                else if(point < 0x110000)
+                {
+                    converted.push_back((char)(0xF0 | (point >> 18)));
+                    converted.push_back((char)(0x80 | ((point >> 12) & 0x3F)));
+                    converted.push_back((char)(0x80 | ((point >> 6) & 0x3F)));
+                    converted.push_back((char)(0x80 | (point & 0x3F)));
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        ///Converts UTF-8 path into path characters, as UTF-16 or UTF-32 according to character size. Returns false if path isn't valid UTF-8.
+        static bool decodePath(const std::string& string, std::basic_string<path_type>& converted)
+        {
+            if constexpr(sizeof(path_type) == 1)
+            {
+                //Paths of bytes are kept in UTF-8.
+                converted.assign(string.begin(), string.end());
+                return true;
+            }
+            converted.clear();
+            for(size_t i = 0; i < string.size();)
+            {
+                unsigned char first = (unsigned char)string[i];
+                size_t extra = (first < 0x80)?(0):((first >> 5 == 0x6)?(1):((first >> 4 == 0xE)?(2):((first >> 3 == 0x1E)?(3):(4))));
+                if(extra == 4 or i + extra >= string.size())
+                {
+                    return false;
+                }
+                std::uint32_t point = (extra == 0)?(first):(first & (0x3F >> extra));
+                for(size_t j = 1; j <= extra; ++j)
+                {
+                    unsigned char next = (unsigned char)string[i + j];
+                    if((next & 0xC0) != 0x80)
+                    {
+                        return false;
+                    }
+                    point = (point << 6) | (next & 0x3F);
+                }
+                i += extra + 1;
+                if(point > 0x10FFFF or (point >= 0xD800 and point <= 0xDFFF))
+                {
+                    return false;
+                }
+                if constexpr(sizeof(path_type) == 2)
+                {
+                    if(point >= 0x10000)
+                    {
+                        converted.push_back((path_type)(0xD800 + ((point - 0x10000) >> 10)));
+                        converted.push_back((path_type)(0xDC00 + ((point - 0x10000) & 0x3FF)));
+                        continue;
+                    }
+                }
+                converted.push_back((path_type)point);
+            }
+            return true;
+        }
+
+        ///Returns stored path as accepted by C functions. Paths of char are returned directly, others are converted into storage. Returns nullptr if conversion failed.
+        const char* nativePath(std::string& storage) const
+        {
+            if constexpr(std::is_same<path_type, char>::value)
+            {
+                (void)storage;
+                return privatePath;
+            }
+            else
+            {
+                return (encodePath(privatePath, storage))?(storage.c_str()):(nullptr);
+            }
+        }
+
+        ///Checks that stream can be opened with choosen path and finds its length.
+        bool checkPath(const path_type* const& choosenPath, size_t& length, int errorCode)
+        {
+            if(choosenPath == nullptr or isStreamOpen())
+            {
+                //Ensure nothing will be broken.
+                privateError = errorCode;
+                return false;
+            }
+            if(!pathLength(choosenPath, length))
+            {
+                //Either file too long or this isn't valid string.
+                privateError = ENAMETOOLONG;
+                return false;
+            }
+            return true;
+        }
+
+        ///Opens file relative to directory with flags matching fopen modes.
+        static FILE* openRelative(const fileDirectory& directory, const char* name, unsigned short openingMode, const char* modeString)
+        {
+            #ifdef LIBFILESTREAM_POSIX
+            const int flags[] = {O_RDONLY, O_WRONLY | O_CREAT | O_TRUNC, O_WRONLY | O_CREAT | O_APPEND, O_RDWR, O_RDWR | O_CREAT | O_TRUNC, O_RDWR | O_CREAT | O_APPEND};
+            int descriptor = openat(directory.handle(), name, flags[openingMode - 1] | O_CLOEXEC, 0666);
+            if(descriptor < 0)
+            {
+                return nullptr;
+            }
+            FILE* opened = fdopen(descriptor, modeString);
+            if(opened == nullptr)
+            {
+                ::close(descriptor);
+            }
+            return opened;
+            #else
+            (void)directory;
+            (void)name;
+            (void)openingMode;
+            (void)modeString;
+            errno = ENOTSUP;
+            return nullptr;
+            #endif
+        }
+
+        /**Opens stream with path of known length.
+        *If directory is given, path is opened relative to it, and stored path is joined with path of directory only to name the file.
+        */
+        void openPath(const path_type* choosenPath, size_t length, unsigned short openingMode, bool binaryMode, int errorCode, const fileDirectory* directory = nullptr)
+        {
+            if(openingMode < 1 or openingMode > 6)
+            {
+                privateError = errorCode;
+                return;
+            }
+            std::string relative;
+            if(directory != nullptr)
+            {
+                std::basic_string<path_type> name(choosenPath, length);
+                if(!encodePath(name.c_str(), relative))
+                {
+                    privateError = EILSEQ;
+                    return;
+                }
+                std::basic_string<path_type> joined;
+                if constexpr(std::is_same<path_type, char>::value)
+                {
+                    joined = directory->joinedPath(relative.c_str());
+                }
+                else if(!decodePath(directory->joinedPath(relative.c_str()), joined))
+                {
+                    privateError = EILSEQ;
+                    return;
+                }
+                storePath(joined.c_str(), joined.size());
+            }
+            else
+            {
+                storePath(choosenPath, length);
+            }
+            std::string storage;
+            const char* native = (directory != nullptr)?(relative.c_str()):(nativePath(storage));
+            if(native == nullptr)
+            {
+                privateError = EILSEQ;
+                releasePath();
+                return;
+            }
+            const char* modes[] = {"r", "w", "a", "r+", "w+", "a+", "rb", "wb", "ab", "rb+", "wb+", "ab+"};
+            const char* modeString = modes[openingMode - 1 + ((binaryMode)?(6):(0))];
+            file = (directory != nullptr)?(openRelative(*directory, native, openingMode, modeString)):(fopen(native, modeString));
+            if(file == nullptr)
+            {
+                privateError = extractError();
+                releasePath();
+                return;
+            }
+            if(openingMode == 2 or openingMode == 5)
+            {
+                //Truncated file has no lines of old sidecar.
+                dropLineIndex();
+            }
+            privateBinaryMode = binaryMode;
+            privateMode = openingMode;
+            updateEndOfFile();
+        }
+
+        bool isError()
+        {
+            return (ferror(file) != 0) or (errno != 0);
+        }
+        
+        //Clears default error variables to collect new error messages.
+        void clearErrorPointing()
+        {
+            if(ferror(file) or feof(file))
+            {
+                clearerr(file);
+            }
+            errno = 0;
+        }
+
+        int extractError()
+        {
+            if(isStreamOpen() and (ferror(file) != 0))
+            {
+                return ferror(file);
+            }
+            else if(errno != 0)
+            {
+                return errno;
+            }
+            else
+            {
+                return privateError;
+            }
+            return 0;
+        }
+
+        ///Updates End Of File information to insure, that clearerr can't remove end of file data.
+        void updateEndOfFile()
+        {
+            #ifdef LIBFILESTREAM_COMPRESSION
+            if(privateCompression != nullptr)
+            {
+                //Compressed stream knows it without seeking through compressed data.
+                privateEndOfFile = privateCompression->isEnd();
+                return;
+            }
+            #endif
+            if(privateMapping != nullptr)
+            {
+                privateEndOfFile = privateMapping->position >= privateMapping->size;
+                return;
+            }
+            if(privateEncoding != nullptr and (privateEncoding->unused() != 0 or privateEncoding->pendingPlace < privateEncoding->pendingUnits.size()))
+            {
+                //C stream is at the end, but read text wasn't returned yet.
+                privateEndOfFile = false;
+                return;
+            }
+            if(privateAtomic != nullptr)
+            {
+                //Every write ends here, so it is the place to start background writeback.
+                privateAtomic->backgroundFlush(file);
+            }
+            if(privateMemory != nullptr and privateMemory->spillThreshold != 0)
+            {
+                //Every write ends here, so it is the place to check whenever memory grew too big.
+                spillMemory();
+            }
+            if(privateMode == 3)
+            {
+                //Append only stream is always at the end and can't report its size.
+                privateEndOfFile = true;
+                return;
+            }
+            if(point() >= size())
+            {
+                privateEndOfFile = true;
+            }
+            privateEndOfFile = (privateEndOfFile)?(true):(feof(file));
+        }
+
+        public:
+
+        fileStream(fileStream&& movedFrom)
+        {
+            close();
+            file = movedFrom.file;
+            movedFrom.file = nullptr;
+            privateMode = movedFrom.privateMode;
+            movedFrom.privateMode = 0;
+            privateBinaryMode = movedFrom.privateBinaryMode;
+            movedFrom.privateBinaryMode = false;
+            privateError = movedFrom.privateError;
+            movedFrom.privateError = 0;
+            privateEndOfFile = movedFrom.privateEndOfFile;
+            movedFrom.privateEndOfFile = false;
+            if(movedFrom.privatePath == movedFrom.privateInlinePath)
+            {
+                storePath(movedFrom.privatePath, stringLength(movedFrom.privatePath));
+            }
+            else
+            {
+                privatePath = movedFrom.privatePath;
+            }
+            movedFrom.privatePath = nullptr;
+            privateCompression = movedFrom.privateCompression;
+            movedFrom.privateCompression = nullptr;
+            privateLineIndex = movedFrom.privateLineIndex;
+            movedFrom.privateLineIndex = nullptr;
+            privateAtomic = movedFrom.privateAtomic;
+            movedFrom.privateAtomic = nullptr;
+            privateMapping = movedFrom.privateMapping;
+            movedFrom.privateMapping = nullptr;
+            privateChecksum = movedFrom.privateChecksum;
+            movedFrom.privateChecksum = nullptr;
+            privateEncoding = movedFrom.privateEncoding;
+            movedFrom.privateEncoding = nullptr;
+            privateMemory = movedFrom.privateMemory;
+            movedFrom.privateMemory = nullptr;
+            privateResource = movedFrom.privateResource;
+            movedFrom.privateResource = nullptr;
+            privateArena = movedFrom.privateArena;
+            movedFrom.privateArena = nullptr;
+        }
+
+        ///Checks whenever stream is open.
+        bool isStreamOpen() const
+        {
+            return file != nullptr and privateMode != 0;
+        }
+
+        ///Checks whenever stream is valid for reading.
+        bool isValidForReading() const
+        {
+            //Mapped stream supports only binary functions.
+            return file != nullptr and !privateEndOfFile and (privateMode == 1 or (privateMode >= 4 and privateMode <= 6)) and privateMapping == nullptr;
+        }
+
+        //Checks whenever stream is valid for writing.
+        bool isValidForWriting() const
+        {
+            return file != nullptr and (privateMode >= 2 and privateMode <= 6) and privateMapping == nullptr;
+        }
+
+        ///Checks whenever stream is valid for reading.
+        bool isValidForTextReading() const
+        {
+            return file != nullptr and !privateEndOfFile and (privateMode == 1 or (privateMode >= 4 and privateMode <= 6)) and !privateBinaryMode;
+        }
+
+        //Checks whenever stream is valid for writing.
+        bool isValidForTextWriting() const
+        {
+            return file != nullptr and (privateMode >= 2 and privateMode <= 6) and !privateBinaryMode;
+        }
+
+        ///Checks whenever stream is valid for binary reading.
+        bool isValidForBinaryReading() const
+        {
+            return (file != nullptr) and (!privateEndOfFile) and (privateMode == 1 or (privateMode >= 4 and privateMode <= 6)) and privateBinaryMode;
+        }
+
+        ///Checks whenever stream is valid for binary writing.
+        bool isValidForBinaryWriting() const
+        {
+            return file != nullptr and (privateMode >= 2 and privateMode <= 6) and privateBinaryMode and (privateMapping == nullptr or privateMapping->writable);
+        }
+
+        private:
+
+        //Checks whenever two lists are equal.
+        template<class type>
+        static bool equalList(const type list1[], const type list2[], size_t size)
+        {
+            bool isEqual = true;
+            for(size_t i = 0; i < size; ++i)
+            {
+                if(list1[i] != list2[i])
+                {
+                    isEqual = false;
+                    break;
+                }
+            }
+            return isEqual;
+        }
+
+        //Checks whenever strings are same.
+        template<class type>
+        static bool isStringsEqual(const type* const& string1, const type* const& string2)
+        {
+            if(stringLength(string1) != stringLength(string2))
+            {
+                return false;
+            }
+            return equalList<type>(string1, string2, stringLength(string2));
+        }
+
+        ///Disallow unauthorized creation of file stream copies.
+        fileStream<path_type>( const fileStream<path_type>&) = delete;
+
+        ///Library parts working directly with the C stream.
+        friend struct fileGroupCommit;
+
+        friend struct fileStreamPool;
+
+        friend struct fileFollower;
+
+        template<class other_path_type>
+        friend struct fileStream;
+
+    public:
+        //Data, available to anything outside structure.
+
+        ///Allow sending file stream in correct way.
+        fileStream<path_type>() = default;
+
+        ///Default error code of all functions.
+        const static unsigned short defaultErrorCode = 112;
+        
+        //const unsigned short defaultErrorCode = 1; //Invalid use of non-static data member 'defaultErrorCode' (non static? Hm...)
+
+        ///Opened file mode. 1 = read; 2 = write; 3 = append; 4 = read and write, but file must exist; 5 = read and write; 6 = read and append. Uneditable from outside.
+        const unsigned short &mode = privateMode;
+
+        ///Is binary mode used.
+        const unsigned short &binary = privateBinaryMode;
+
+        ///Last error storage. Uneditable from outside.
+        const int &error = privateError;
+
+        ///Securely stored uneditable path to current file.
+        const path_type* const &path = privatePath;
+
+        ///Checks whenever it is end of file.
+        const bool &end = privateEndOfFile;
+
+        ///Cleans errors history.
+        void cleanError()
+        {
+            if(isStreamOpen())
+            {
+                clearErrorPointing();
+            }
+            privateError = 0;
+        }
+
+        ///Cleans error and returns true if error is same as given error.
+        bool ignoreError(const int &ignoredError)
+        {
+            if(privateError == ignoredError)
+            {
+                privateError = 0;
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        ///Function to send error to another function.
+        void handle(bool(handlingFunction)(const unsigned short &))
+        {
+            if(!isError())
+            {
+                return;
+            }
+            bool shouldClose = handlingFunction(extractError());
+            if(shouldClose)
+            {
+                close();
+            }
+        }
+
+        ///Placement in file.
+        size_t point(int errorCode = defaultErrorCode)
+        {
+            if(!isStreamOpen())
+            {
+                privateError = errorCode;
+                return 0;
+            }
+            if(mode == 3)
+            {
+                return 0;
+            }
+            if(privateMapping != nullptr)
+            {
+                return (size_t)privateMapping->position;
+            }
+            if(privateEncoding != nullptr)
+            {
+                return ftell(file) - privateEncoding->unused();
+            }
+            return ftell(file);
+        }
+
+        ///Returns error and clears last error history. Warning! Function not failsafe, and will crash if unsuitable problems occur.
+        int getError()
+        {
+            int returned = privateError;
+            cleanError();
+            return returned;
+        }
+
+        /*Returns file pointer and automatically closes file stream.
+        Caution! Pointer goes out of file stream scope. File stream will be closed after this operation automatically to prevent non library-dependent and broken behavoir.*/
+        FILE* extractPointer()
+        {
+            privateMode = 0;
+            privateBinaryMode = false;
+            releasePath();
+            synchronizeEncoding();
+            delete privateEncoding;
+            privateEncoding = nullptr;
+            FILE* savedFile = file;
+            file = nullptr;
+            privateEndOfFile = false;
+            privateCompression = nullptr; //Compressed state is owned by extracted C stream.
+            delete privateLineIndex;
+            privateLineIndex = nullptr;
+            delete privateAtomic; //Temporary file stays, as extracted pointer refers to it.
+            privateAtomic = nullptr;
+            if(privateMemory != nullptr)
+            {
+                //Extracted pointer keeps memory alive with its own descriptor.
+                privateMemory->close();
+                delete privateMemory;
+                privateMemory = nullptr;
+            }
+            if(privateMapping != nullptr)
+            {
+                privateMapping->close();
+                #ifdef LIBFILESTREAM_POSIX
+                lseek(fileno(savedFile), 0, SEEK_SET);
+                #endif
+                delete privateMapping;
+                privateMapping = nullptr;
+            }
+            return savedFile;
+        }
+
+        /**Chooses memory resource for all returned buffers and internal storage. nullptr returns to new[] and delete[].
+        *Returned buffers must be freed with release while the same memory resource is used.
+        *Can't be changed while stream is open.
+        */
+        void useMemoryResource(std::pmr::memory_resource* resource, int errorCode = defaultErrorCode)
+        {
+            if(isStreamOpen())
+            {
+                privateError = errorCode;
+                return;
+            }
+            delete privateArena;
+            privateArena = nullptr;
+            privateResource = resource;
+        }
+
+        /**Uses own monotonic arena for all returned buffers and internal storage.
+        *Freeing single buffer does nothing, while releaseArena frees all of them in one shot.
+        *Can't be changed while stream is open.
+        */
+        void useArena(size_t initialSize = 65536, std::pmr::memory_resource* upstream = std::pmr::get_default_resource(), int errorCode = defaultErrorCode)
+        {
+            if(isStreamOpen() or upstream == nullptr or initialSize == 0)
+            {
+                privateError = errorCode;
+                return;
+            }
+            delete privateArena;
+            privateArena = new std::pmr::monotonic_buffer_resource(initialSize, upstream);
+            privateResource = privateArena;
+        }
+
+        ///Frees all buffers allocated from own arena at once. Stream stays usable.
+        void releaseArena(int errorCode = defaultErrorCode)
+        {
+            if(privateArena == nullptr)
+            {
+                privateError = errorCode;
+                return;
+            }
+            std::basic_string<path_type> savedPath;
+            bool isPathAllocated = privatePath != nullptr and privatePath != privateInlinePath;
+            if(isPathAllocated)
+            {
+                savedPath = privatePath;
+            }
+            privateArena->release();
+            if(isPathAllocated)
+            {
+                storePath(savedPath.c_str(), savedPath.size());
+            }
+        }
+
+        ///Frees string returned by getString, getLine or getFile, including empty string returned on failure or at the end of file.
+        template<class type>
+        void release(type* string)
+        {
+            if(string != nullptr)
+            {
+                deallocate(string, stringLength(string) + 1);
+            }
+        }
+
+        ///Frees array returned by readBlock, readOrderedBlock or readRecords.
+        template<class type>
+        void release(type* array, size_t count)
+        {
+            deallocate(array, count);
+        }
+
+        /**Opens stream with choosen parameters.
+        *Opening mode supports one of the 6 values. Those are:
+        *1 - read only;
+        *2 - write only;
+        *3 - append only;
+        *4 - read and write, but file should exist;
+        *5 - read and write, but file will be created;
+        *6 - read and append.
+        *To choose whenever or not use binary mode use third bool parameter.
+        */
+        void open(const path_type* const& choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            size_t length = 0;
+            if(!checkPath(choosenPath, length, errorCode))
+            {
+                return;
+            }
+            openPath(choosenPath, length, openingMode, binaryMode, errorCode);
+        }
+
+        ///Opens stream with path given as string view, which doesn't need to be zero terminated. See open for details.
+        void open(std::basic_string_view<path_type> choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            if(isStreamOpen() or choosenPath.data() == nullptr)
+            {
+                privateError = errorCode;
+                return;
+            }
+            if(choosenPath.size() >= maximalPathLength or choosenPath.find(path_type('\0')) != std::basic_string_view<path_type>::npos)
+            {
+                privateError = ENAMETOOLONG;
+                return;
+            }
+            openPath(choosenPath.data(), choosenPath.size(), openingMode, binaryMode, errorCode);
+        }
+
+        /**Opens stream with path relative to open directory, without resolving path of directory again. See open for details.
+        *Stored path of stream is joined with path of directory, so functions reopening the file still work.
+        *Syntax is following:
+        *fileStreamName.open(directoryName, entry.name, 1);
+        */
+        void open(const fileDirectory& directory, const path_type* const& choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            size_t length = 0;
+            if(!directory.isOpen())
+            {
+                privateError = errorCode;
+                return;
+            }
+            if(!checkPath(choosenPath, length, errorCode))
+            {
+                return;
+            }
+            openPath(choosenPath, length, openingMode, binaryMode, errorCode, &directory);
+        }
+
+        ///Opens stream with filesystem path, converted into path characters. See open for details.
+        template<class type, typename = typename std::enable_if<std::is_same<type, std::filesystem::path>::value>::type>
+        void open(const type& choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            if constexpr(std::is_same<path_type, std::filesystem::path::value_type>::value)
+            {
+                open(std::basic_string_view<path_type>(choosenPath.native()), openingMode, binaryMode, errorCode);
+            }
+            else
+            {
+                //Conversion through UTF-8 doesn't depend on locale.
+                auto bytes = choosenPath.u8string();
+                std::basic_string<path_type> converted;
+                if(!decodePath(std::string(bytes.begin(), bytes.end()), converted))
+                {
+                    privateError = EILSEQ;
+                    return;
+                }
+                open(std::basic_string_view<path_type>(converted), openingMode, binaryMode, errorCode);
+            }
+        }
+
+        /**Opens stream with choosen parameters.
+        *Opening mode supports one of the 6 values. Those are:
+        *1 - read only;
+        *2 - write only;
+        *3 - append only;
+        *4 - read and write, but file should exist;
+        *5 - read and write, but file will be created;
+        *6 - read and append.
+        *To choose whenever or not use binary mode use third bool parameter.
+        */
+        fileStream(const path_type* const& choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            open(choosenPath, openingMode, binaryMode, errorCode);
+        }
+
+        ///Opens stream with path given as string view. See open for details.
+        fileStream(std::basic_string_view<path_type> choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            open(choosenPath, openingMode, binaryMode, errorCode);
+        }
+
+        ///Opens stream with filesystem path. See open for details.
+        template<class type, typename = typename std::enable_if<std::is_same<type, std::filesystem::path>::value>::type>
+        fileStream(const type& choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            open(choosenPath, openingMode, binaryMode, errorCode);
+        }
+
+        /**Opens compressed stream with choosen parameters. All reading and writing functions work unchanged over it.
+        *Opening mode supports one of the 3 values. Those are:
+        *1 - read only;
+        *2 - write only;
+        *3 - append only, new data is added as new compressed blocks.
+        *Seeking is supported only for reading. It is fast if block index is used, otherwise data is decompressed up to choosen place.
+        *Requires LIBFILESTREAM_USE_ZLIB, otherwise sets ENOTSUP error.
+        */
+        void open(const path_type* const& choosenPath, unsigned short openingMode, bool binaryMode, const fileCompression& compression, int errorCode = defaultErrorCode)
+        {
+            size_t length = 0;
+            if(!checkPath(choosenPath, length, errorCode))
+            {
+                return;
+            }
+            #ifdef LIBFILESTREAM_COMPRESSION
+            storePath(choosenPath, length);
+            std::string storage;
+            const char* native = nativePath(storage);
+            errno = 0;
+            file = (native != nullptr)?(fileCompressionState::open(native, openingMode, compression, &privateCompression)):(nullptr);
+            if(file == nullptr)
+            {
+                privateCompression = nullptr;
+                privateError = (native == nullptr)?(EILSEQ):((errno != 0)?(errno):(errorCode));
+                releasePath();
+                return;
+            }
+            privateBinaryMode = binaryMode;
+            privateMode = openingMode;
+            updateEndOfFile();
+            return;
+            #endif
+            (void)openingMode;
+            (void)binaryMode;
+            (void)compression;
+            privateError = ENOTSUP;
+        }
+
+        ///Opens compressed stream with choosen parameters. See open for details.
+        fileStream(const path_type* const& choosenPath, unsigned short openingMode, bool binaryMode, const fileCompression& compression, int errorCode = defaultErrorCode)
+        {
+            open(choosenPath, openingMode, binaryMode, compression, errorCode);
+        }
+
+        /**Opens stream with choosen parameters and reserves storage for expected size of file. See open and reserve for details.
+        *Reservation is only a hint, so it is skipped if file system doesn't support it.
+        *Syntax is following:
+        *fileStreamName.open("file.bin", 2, true, allocation);
+        */
+        void open(const path_type* const& choosenPath, unsigned short openingMode, bool binaryMode, const fileAllocation& allocation, int errorCode = defaultErrorCode)
+        {
+            open(choosenPath, openingMode, binaryMode, errorCode);
+            if(!isStreamOpen() or allocation.expectedSize == 0 or !isValidForWriting())
+            {
+                return;
+            }
+            reserve(allocation.expectedSize, errorCode);
+            if(privateError == ENOTSUP or privateError == EOPNOTSUPP)
+            {
+                privateError = 0;
+            }
+        }
+
+        ///Opens stream and reserves storage for expected size of file. See open for details.
+        fileStream(const path_type* const& choosenPath, unsigned short openingMode, bool binaryMode, const fileAllocation& allocation, int errorCode = defaultErrorCode)
+        {
+            open(choosenPath, openingMode, binaryMode, allocation, errorCode);
+        }
+
+        /**Closes stream. No parameters needed.
+        *Can and must be called even if the stream has been corrupted.
+        */
+        void close()
+        {
+            if(privateAtomic != nullptr)
+            {
+                //Closing atomically written stream publishes it.
+                commit();
+                return;
+            }
+            if(privateLineIndex != nullptr)
+            {
+                if(privateMode == 3 or privateMode == 6)
+                {
+                    //Keep index of appended file up to date.
+                    updateLineIndex();
+                }
+                delete privateLineIndex;
+                privateLineIndex = nullptr;
+            }
+            if(privateMapping != nullptr)
+            {
+                if(!privateMapping->close())
+                {
+                    privateError = errno;
+                }
+                delete privateMapping;
+                privateMapping = nullptr;
+            }
+            if(file != nullptr)
+            {
+                //rewind(file);
+                fclose(file); //Also finishes compressed stream.
+                file = nullptr;
+            }
+            privateCompression = nullptr;
+            delete privateEncoding;
+            privateEncoding = nullptr;
+            if(privateMemory != nullptr)
+            {
+                privateMemory->close();
+                delete privateMemory;
+                privateMemory = nullptr;
+            }
+            privateMode = 0;
+            privateBinaryMode = false;
+            //privateError = 0; //No need to clear last error log.
+            privateEndOfFile = false;
+            releasePath();
+        }
+
+        /**Opens binary stream mapped into memory, so binary reading and writing become copying into mapping.
+        *Opening mode supports one of the 3 values. Those are:
+        *1 - read only;
+        *4 - read and write, but file should exist;
+        *5 - read and write, but file will be created.
+        *Writes past the end grow file and mapping automatically. Text functions aren't available.
+        *While writable stream is open, file is extended to capacity of mapping. Closing cuts it to its real size.
+        *Syntax is following:
+        *fileStreamName.openMapped("file.bin", 4, mapping);
+        */
+        void openMapped(const path_type* const& choosenPath, unsigned short openingMode = 4, const fileMapping& mapping = fileMapping(), int errorCode = defaultErrorCode)
+        {
+            size_t length = 0;
+            if(!checkPath(choosenPath, length, errorCode))
+            {
+                return;
+            }
+            if(openingMode != 1 and openingMode != 4 and openingMode != 5)
+            {
+                privateError = errorCode;
+                return;
+            }
+            #ifdef LIBFILESTREAM_POSIX
+            openPath(choosenPath, length, openingMode, true, errorCode);
+            if(!isStreamOpen())
+            {
+                return;
+            }
+            fileMappingState* state = new fileMappingState;
+            errno = 0;
+            if(!state->open(fileno(file), openingMode != 1, mapping))
+            {
+                int mappingError = (errno != 0)?(errno):(errorCode);
+                state->close();
+                delete state;
+                close();
+                privateError = mappingError;
+                return;
+            }
+            privateMapping = state;
+            privateEndOfFile = false;
+            updateEndOfFile();
+            #else
+            privateError = ENOTSUP;
+            #endif
+        }
+
+        ///Opens binary stream mapped into memory. See openMapped for details.
+        fileStream(const path_type* const& choosenPath, unsigned short openingMode, const fileMapping& mapping, int errorCode = defaultErrorCode)
+        {
+            openMapped(choosenPath, openingMode, mapping, errorCode);
+        }
+
+        /**Opens stream kept in memory instead of file, with all functions of stream opened by open. Memory is freed by closing.
+        *Opening mode supports the same 6 values as open, mode 1 and 4 streams start empty and are useful after reopen.
+        *Path of stream names memory while it is open, so it can be opened by other functions, or given out by extractPointer.
+        *Stream is moved into spill file once it grows past spill threshold, and path becomes path of spill file.
+        *Memory has no place for sidecar files, so line index is kept only in memory and loadLineIndex fails with ENOTSUP, compression and mapping aren't available.
+        *Syntax is following:
+        *fileStreamName.openMemory(memory, 5, binaryMode);
+        */
+        void openMemory(const fileMemory& memory = fileMemory(), unsigned short openingMode = 5, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            if(isStreamOpen() or openingMode < 1 or openingMode > 6 or (memory.spillThreshold != 0 and memory.spillPath.empty()))
+            {
+                privateError = errorCode;
+                return;
+            }
+            fileMemoryState* state = new fileMemoryState;
+            state->spillThreshold = memory.spillThreshold;
+            state->spillPath = memory.spillPath;
+            errno = 0;
+            const char* modes[] = {"r", "w", "a", "r+", "w+", "a+", "rb", "wb", "ab", "rb+", "wb+", "ab+"};
+            file = (state->open())?(state->stream(openingMode, modes[openingMode - 1 + ((binaryMode)?(6):(0))])):(nullptr);
+            if(file == nullptr)
+            {
+                privateError = (errno != 0)?(errno):(errorCode);
+                state->close();
+                delete state;
+                return;
+            }
+            std::string name = state->path();
+            std::basic_string<path_type> storedName(name.begin(), name.end()); //Name is ASCII.
+            storePath(storedName.c_str(), storedName.size());
+            privateMemory = state;
+            privateBinaryMode = binaryMode;
+            privateMode = openingMode;
+            privateEndOfFile = false;
+            updateEndOfFile();
+        }
+
+        ///Opens stream kept in memory. See openMemory for details.
+        fileStream(const fileMemory& memory, unsigned short openingMode = 5, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            openMemory(memory, openingMode, binaryMode, errorCode);
+        }
+
+        /**Opens stream, which atomically replaces file at choosen path.
+        *Data is written into temporary file in the same directory. Commit or close synchronizes it, renames it over the target and synchronizes directory, while rollback discards it.
+        *Until then target is left untouched, so crash never leaves partially written file.
+        *Destruction during unwinding of exception rolls back instead, so failed writing doesn't replace target with partial data.
+        *Opening mode supports one of the 2 values. Those are:
+        *2 - write only;
+        *5 - read and write.
+        *Durability settings choose between fdatasync and fsync and allow starting writeback during big writes.
+        */
+        void openAtomic(const path_type* const& choosenPath, unsigned short openingMode = 2, bool binaryMode = false, const fileDurability& durability = fileDurability(), int errorCode = defaultErrorCode)
+        {
+            size_t length = 0;
+            if(!checkPath(choosenPath, length, errorCode))
+            {
+                return;
+            }
+            if((openingMode != 2 and openingMode != 5) or (durability.synchronization != 1 and durability.synchronization != 2))
+            {
+                privateError = errorCode;
+                return;
+            }
+            #ifdef LIBFILESTREAM_POSIX
+            storePath(choosenPath, length);
+            std::string storage;
+            const char* native = nativePath(storage);
+            if(native == nullptr)
+            {
+                privateError = EILSEQ;
+                releasePath();
+                return;
+            }
+            fileAtomicState* atomic = new fileAtomicState;
+            atomic->durability = durability;
+            int descriptor = atomic->create(native);
+            if(descriptor < 0)
+            {
+                privateError = (errno != 0)?(errno):(errorCode);
+                delete atomic;
+                releasePath();
+                return;
+            }
+            file = fdopen(descriptor, (openingMode == 2)?((binaryMode)?("wb"):("w")):((binaryMode)?("wb+"):("w+")));
+            if(file == nullptr)
+            {
+                privateError = (errno != 0)?(errno):(errorCode);
+                ::close(descriptor);
+                remove(atomic->temporaryPath.c_str());
+                delete atomic;
+                releasePath();
+                return;
+            }
+            privateAtomic = atomic;
+            privateBinaryMode = binaryMode;
+            privateMode = openingMode;
+            updateEndOfFile();
+            return;
+            #endif
+            (void)binaryMode;
+            privateError = ENOTSUP;
+        }
+
+        /**Publishes atomically written stream and closes it.
+        *Data is synchronized, temporary file is renamed over the target and directory is synchronized.
+        *On failure target is left untouched and temporary file is removed.
+        */
+        void commit(int errorCode = defaultErrorCode)
+        {
+            if(privateAtomic == nullptr or !isStreamOpen())
+            {
+                privateError = errorCode;
+                return;
+            }
+            fileAtomicState* atomic = privateAtomic;
+            privateAtomic = nullptr;
+            errno = 0;
+            bool succeeded = (fflush(file) == 0) and fileDurability::synchronize(fileno(file), atomic->durability.synchronization);
+            succeeded = (fclose(file) == 0) and succeeded;
+            file = nullptr;
+            std::string storage;
+            const char* native = nativePath(storage);
+            if(succeeded)
+            {
+                succeeded = (rename(atomic->temporaryPath.c_str(), native) == 0) and fileDurability::synchronizeDirectory(native);
+            }
+            if(succeeded)
+            {
+                //Target was replaced, so its sidecar is old.
+                dropLineIndex();
+            }
+            if(!succeeded)
+            {
+                privateError = (errno != 0)?(errno):(errorCode);
+                remove(atomic->temporaryPath.c_str());
+            }
+            delete atomic;
+            close();
+        }
+
+        ///Discards atomically written stream and closes it. Target is left untouched.
+        void rollback(int errorCode = defaultErrorCode)
+        {
+            if(privateAtomic == nullptr or !isStreamOpen())
+            {
+                privateError = errorCode;
+                return;
+            }
+            fclose(file);
+            file = nullptr;
+            remove(privateAtomic->temporaryPath.c_str());
+            delete privateAtomic;
+            privateAtomic = nullptr;
+            close();
+        }
+
+        ///Writes buffered data into the file.
+        void flush(int errorCode = defaultErrorCode)
+        {
+            if(privateMapping != nullptr)
+            {
+                //Mapping has no buffer, so only writeback of its pages is started.
+                syncRange(0, privateMapping->size, 1, errorCode);
+                return;
+            }
+            if(!isValidForWriting())
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            if(fflush(file) != 0)
+            {
+                privateError = (errno != 0)?(errno):(errorCode);
+                clearErrorPointing();
+            }
+        }
+
+        /**Writes buffered data and synchronizes file with storage.
+        *Synchronization supports one of the 2 values:
+        *1 - fdatasync;
+        *2 - fsync.
+        */
+        void sync(unsigned short synchronization = 2, int errorCode = defaultErrorCode)
+        {
+            if(privateMapping != nullptr and privateMapping->writable and (synchronization == 1 or synchronization == 2))
+            {
+                errno = 0;
+                if(!privateMapping->synchronize(0, privateMapping->capacity, 2) or !fileDurability::synchronize(fileno(file), synchronization))
+                {
+                    privateError = (errno != 0)?(errno):(errorCode);
+                    errno = 0;
+                }
+                return;
+            }
+            if(!isValidForWriting() or (synchronization != 1 and synchronization != 2))
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            if(fflush(file) != 0 or !fileDurability::synchronize(fileno(file), synchronization))
+            {
+                privateError = (errno != 0)?(errno):(errorCode);
+                clearErrorPointing();
+            }
+        }
+
+        /**Declares encoding of text. Text functions then transcode between it and their character type: char receives UTF-8, char16_t UTF-16 and char32_t UTF-32.
+        *Encoding supports one of the 6 values:
+        *0 - none, text is read and written byte by byte;
+        *1 - UTF-8;
+        *2 - UTF-16 little endian;
+        *3 - UTF-16 big endian;
+        *4 - UTF-32 little endian;
+        *5 - UTF-32 big endian.
+        *If detectMark is true and stream is readable at the start of file, byte order mark replaces declared encoding and is skipped.
+        *Invalid text sets EILSEQ error. Only text mode is supported.
+        *Syntax is following:
+        *fileStreamName.useEncoding(1);
+        */
+        void useEncoding(unsigned short encoding, bool detectMark = true, int errorCode = defaultErrorCode)
+        {
+            if(!isStreamOpen() or privateBinaryMode or privateMapping != nullptr or (encoding != 0 and !fileEncodingState::isValid(encoding)))
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            synchronizeEncoding();
+            if(encoding == 0)
+            {
+                delete privateEncoding;
+                privateEncoding = nullptr;
+                updateEndOfFile();
+                return;
+            }
+            if(privateEncoding == nullptr)
+            {
+                privateEncoding = new fileEncodingState;
+            }
+            fileEncodingState& state = *privateEncoding;
+            state.encoding = encoding;
+            if(privateMode != 1 and privateMode < 4)
+            {
+                return;
+            }
+            if(!state.fill(file))
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            size_t markSize = 0;
+            unsigned short detected = (detectMark and ftell(file) == (long)state.rawSize)?(fileEncodingState::detect(state.raw.data(), state.rawSize, markSize)):(0);
+            if(detected != 0)
+            {
+                state.encoding = detected;
+                state.rawPlace = markSize;
+            }
+            privateEndOfFile = state.unused() == 0 and state.sourceEnd;
+        }
+
+        ///Returns declared encoding of text, 0 if none. See useEncoding for details.
+        unsigned short textEncoding() const
+        {
+            return (privateEncoding != nullptr)?(privateEncoding->encoding):(0);
+        }
+
+        /**Attaches checksum updated by all bytes read or written by binary functions from now on, so verifying data doesn't need another pass over file.
+        *Positional reading and writing with readAt and writeAt doesn't update it. Checksum stays attached after closing, so digest of closed file can be queried.
+        *Syntax is following:
+        *fileStreamName.attachChecksum(checksum);
+        */
+        void attachChecksum(const fileChecksum& checksum = fileChecksum(), int errorCode = defaultErrorCode)
+        {
+            if(checksum.algorithm < 1 or checksum.algorithm > 3 or (checksum.algorithm == 3 and (checksum.update == nullptr or checksum.finish == nullptr)))
+            {
+                privateError = errorCode;
+                return;
+            }
+            if(privateChecksum == nullptr)
+            {
+                privateChecksum = new fileChecksumState;
+            }
+            privateChecksum->settings = checksum;
+            privateChecksum->reset();
+        }
+
+        ///Detaches checksum.
+        void detachChecksum()
+        {
+            delete privateChecksum;
+            privateChecksum = nullptr;
+        }
+
+        /**Returns checksum of all bytes read or written since attaching or resetting. CRC32C is returned in the lower 32 bits.
+        *Syntax is following:
+        *std::uint64_t digest = fileStreamName.checksum();
+        */
+        std::uint64_t checksum(int errorCode = defaultErrorCode)
+        {
+            if(privateChecksum == nullptr)
+            {
+                privateError = errorCode;
+                return 0;
+            }
+            return privateChecksum->digest();
+        }
+
+        ///Starts attached checksum again, for example after seeking to verify another part of file. User supplied digest is reset by its owner.
+        void resetChecksum(int errorCode = defaultErrorCode)
+        {
+            if(privateChecksum == nullptr)
+            {
+                privateError = errorCode;
+                return;
+            }
+            privateChecksum->reset();
+        }
+
+        /**Writes choosen range of file to storage.
+        *Synchronization supports one of the 2 values:
+        *1 - asynchronous, writeback is only started;
+        *2 - synchronous, waits until data is written.
+        *Mapped streams use msync, others sync_file_range where available and whole file synchronization otherwise.
+        *Syntax is following:
+        *fileStreamName.syncRange(offset, length, synchronization);
+        */
+        void syncRange(std::uint64_t offset, std::uint64_t length, unsigned short synchronization = 2, int errorCode = defaultErrorCode)
+        {
+            if(!isStreamOpen() or privateMode == 1 or (synchronization != 1 and synchronization != 2))
+            {
+                privateError = errorCode;
+                return;
+            }
+            errno = 0;
+            if(privateMapping != nullptr)
+            {
+                if(!privateMapping->synchronize(offset, length, synchronization))
+                {
+                    privateError = (errno != 0)?(errno):(errorCode);
+                    errno = 0;
+                }
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            if(fflush(file) != 0)
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            #if defined(__linux__) && defined(_GNU_SOURCE)
+            unsigned int flags = (synchronization == 1)?(SYNC_FILE_RANGE_WRITE):(SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+            bool succeeded = sync_file_range(fileno(file), (off64_t)offset, (off64_t)length, flags) == 0;
+            #else
+            (void)offset;
+            (void)length;
+            bool succeeded = (synchronization == 1) or fileDurability::synchronize(fileno(file), 1);
+            #endif
+            if(!succeeded)
+            {
+                privateError = (errno != 0)?(errno):(errorCode);
+                clearErrorPointing();
+            }
+        }
+
+        /**Finds the first region containing data at or after choosen place. Returns false if there is no more data.
+        *Without SEEK_DATA and SEEK_HOLE support whole file is reported as single region.
+        *Position of stream isn't changed.
+        *Syntax is following:
+        *for(fileExtent extent; fileStreamName.findExtent(extent.offset + extent.length, extent);)
+        */
+        bool findExtent(std::uint64_t from, fileExtent& extent, int errorCode = defaultErrorCode)
+        {
+            if(!isStreamOpen() or privateCompression != nullptr)
+            {
+                privateError = errorCode;
+                return false;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            if(fflush(file) != 0)
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return false;
+            }
+            #ifdef LIBFILESTREAM_POSIX
+            int descriptor = fileno(file);
+            struct stat information;
+            if(fstat(descriptor, &information) != 0)
+            {
+                privateError = errno;
+                clearErrorPointing();
+                return false;
+            }
+            //Mapped file is extended to capacity of mapping, data ends at its real size.
+            std::uint64_t fileSize = (privateMapping != nullptr)?(privateMapping->size):((std::uint64_t)information.st_size);
+            if(from >= fileSize)
+            {
+                return false;
+            }
+            #if defined(__linux__) && defined(_GNU_SOURCE)
+            off_t current = lseek(descriptor, 0, SEEK_CUR);
+            off_t start = lseek(descriptor, (off_t)from, SEEK_DATA);
+            off_t end = (start >= 0)?(lseek(descriptor, start, SEEK_HOLE)):(-1);
+            int searchError = errno;
+            lseek(descriptor, current, SEEK_SET);
+            if(start < 0 or end < 0)
+            {
+                if(searchError == ENXIO)
+                {
+                    //No more data after choosen place.
+                    errno = 0;
+                    return false;
+                }
+                if(searchError != EINVAL and searchError != ENOTSUP)
+                {
+                    privateError = searchError;
+                    clearErrorPointing();
+                    return false;
+                }
+                //File system doesn't support searching, so everything is data.
+                errno = 0;
+                start = (off_t)from;
+                end = (off_t)fileSize;
+            }
+            if((std::uint64_t)start >= fileSize)
+            {
+                return false;
+            }
+            extent.offset = (std::uint64_t)start;
+            extent.length = (((std::uint64_t)end < fileSize)?((std::uint64_t)end):(fileSize)) - (std::uint64_t)start;
+            #else
+            extent.offset = from;
+            extent.length = fileSize - from;
+            #endif
+            return true;
+            #else
+            (void)from;
+            (void)extent;
+            privateError = ENOTSUP;
+            return false;
+            #endif
+        }
+
+        /**Returns all regions containing data, in order of their places.
+        *Syntax is following:
+        *std::vector<fileExtent> extents = fileStreamName.extents();
+        */
+        std::vector<fileExtent> extents(int errorCode = defaultErrorCode)
+        {
+            std::vector<fileExtent> found;
+            fileExtent extent;
+            while(findExtent(extent.offset + extent.length, extent, errorCode))
+            {
+                found.push_back(extent);
+            }
+            return found;
+        }
+
+        /**Copies whole content of source stream into this one, writing only regions containing data, so holes stay holes.
+        *Previous content of this stream is discarded, it is resized to the size of source and its position is moved to the end.
+        *Positions of source isn't changed. Stream can't be in append mode.
+        *Syntax is following:
+        *fileStreamName.copySparse(sourceFileStreamName);
+        */
+        template<class other_path_type>
+        void copySparse(fileStream<other_path_type>& source, int errorCode = defaultErrorCode)
+        {
+            if(!isValidForWriting() or privateMode == 3 or privateMode == 6 or privateCompression != nullptr or privateAtomic != nullptr or !source.isStreamOpen() or source.privateMode == 2 or source.privateMode == 3)
+            {
+                privateError = errorCode;
+                return;
+            }
+            #ifdef LIBFILESTREAM_POSIX
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex(0);
+            if(fflush(file) != 0)
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            int input = fileno(source.file), output = fileno(file);
+            //Old data would stay where source has holes, so it is removed first.
+            if(ftruncate(output, 0) != 0)
+            {
+                privateError = errno;
+                clearErrorPointing();
+                return;
+            }
+            std::vector<char> buffer(conversionBufferSize * 16);
+            fileExtent extent;
+            while(source.findExtent(extent.offset + extent.length, extent, errorCode))
+            {
+                for(std::uint64_t done = 0; done < extent.length;)
+                {
+                    size_t part = (extent.length - done < buffer.size())?((size_t)(extent.length - done)):(buffer.size());
+                    ssize_t got = pread(input, buffer.data(), part, (off_t)(extent.offset + done));
+                    if(got <= 0)
+                    {
+                        privateError = (got < 0)?(errno):(errorCode);
+                        clearErrorPointing();
+                        return;
+                    }
+                    for(ssize_t written = 0; written < got;)
+                    {
+                        ssize_t result = pwrite(output, buffer.data() + written, (size_t)(got - written), (off_t)(extent.offset + done + written));
+                        if(result < 0)
+                        {
+                            privateError = errno;
+                            clearErrorPointing();
+                            return;
+                        }
+                        written += result;
+                    }
+                    done += (std::uint64_t)got;
+                }
+            }
+            if(source.error != 0)
+            {
+                privateError = source.error;
+                return;
+            }
+            struct stat information;
+            if(fstat(input, &information) != 0 or ftruncate(output, information.st_size) != 0)
+            {
+                privateError = errno;
+                clearErrorPointing();
+                return;
+            }
+            //Descriptor was used directly, so stream position is synchronized again.
+            fseek(file, 0, SEEK_END);
+            updateEndOfFile();
+            #else
+            privateError = ENOTSUP;
+            #endif
+        }
+
+        /**Deallocates choosen range, turning it into hole which reads as zeros. Size of file isn't changed.
+        *Requires fallocate with FALLOC_FL_PUNCH_HOLE.
+        *Syntax is following:
+        *fileStreamName.punchHole(offset, length);
+        */
+        void punchHole(std::uint64_t offset, std::uint64_t length, int errorCode = defaultErrorCode)
+        {
+            if(!isValidForWriting() or privateCompression != nullptr)
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex(offset);
+            if(fflush(file) != 0)
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            #if defined(__linux__) && defined(_GNU_SOURCE)
+            if(fallocate(fileno(file), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, (off_t)offset, (off_t)length) != 0)
+            {
+                privateError = errno;
+                clearErrorPointing();
+            }
+            #else
+            (void)offset;
+            (void)length;
+            privateError = ENOTSUP;
+            #endif
+        }
+
+        /**Allocates storage for choosen range, so writing into it won't fail for lack of space nor fragment file.
+        *If keepSize is true, size of file isn't changed even if range exceeds it.
+        *Uses fallocate where available and posix_fallocate otherwise, which always extends the file, so there range past end of file fails with ENOTSUP if keepSize is true.
+        *Syntax is following:
+        *fileStreamName.preallocate(offset, length);
+        */
+        void preallocate(std::uint64_t offset, std::uint64_t length, bool keepSize = true, int errorCode = defaultErrorCode)
+        {
+            if(!isValidForWriting() or privateCompression != nullptr)
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            if(fflush(file) != 0)
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            #if defined(__linux__) && defined(_GNU_SOURCE)
+            if(fallocate(fileno(file), (keepSize)?(FALLOC_FL_KEEP_SIZE):(0), (off_t)offset, (off_t)length) != 0)
+            {
+                privateError = errno;
+                clearErrorPointing();
+            }
+            #elif defined(LIBFILESTREAM_POSIX)
+            struct stat information;
+            if(keepSize and fstat(fileno(file), &information) != 0)
+            {
+                privateError = errno;
+                clearErrorPointing();
+                return;
+            }
+            if(keepSize and offset + length > (std::uint64_t)information.st_size)
+            {
+                privateError = ENOTSUP;
+                return;
+            }
+            int result = posix_fallocate(fileno(file), (off_t)offset, (off_t)length);
+            if(result != 0)
+            {
+                privateError = result;
+                clearErrorPointing();
+            }
+            #else
+            (void)offset;
+            (void)length;
+            (void)keepSize;
+            privateError = ENOTSUP;
+            #endif
+        }
+
+        /**Reserves storage for file of choosen size without changing its size, so following writes neither fragment the file nor fail for lack of space.
+        *Without fallocate, reserving past end of file fails with ENOTSUP instead of changing size.
+        *Syntax is following:
+        *fileStreamName.reserve(bytes);
+        */
+        void reserve(std::uint64_t bytes, int errorCode = defaultErrorCode)
+        {
+            preallocate(0, bytes, true, errorCode);
+        }
+
+        /**Truncates or extends file to choosen size. Extended part reads as zeros. Position of stream isn't changed.
+        *Syntax is following:
+        *fileStreamName.resize(bytes);
+        */
+        void resize(std::uint64_t bytes, int errorCode = defaultErrorCode)
+        {
+            if(privateMapping != nullptr and privateMapping->writable)
+            {
+                invalidateLineIndex(bytes);
+                //File keeps capacity of mapping until closing, so only its real size is changed.
+                errno = 0;
+                if(bytes < privateMapping->size)
+                {
+                    std::memset(privateMapping->data + bytes, 0, (size_t)(privateMapping->size - bytes));
+                }
+                else if(!privateMapping->ensure(bytes))
+                {
+                    privateError = (errno != 0)?(errno):(errorCode);
+                    errno = 0;
+                    return;
+                }
+                privateMapping->size = bytes;
+                updateEndOfFile();
+                return;
+            }
+            if(!isValidForWriting() or privateCompression != nullptr)
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex(bytes);
+            if(fflush(file) != 0)
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            #ifdef LIBFILESTREAM_POSIX
+            if(ftruncate(fileno(file), (off_t)bytes) != 0)
+            {
+                privateError = errno;
+                clearErrorPointing();
+                return;
+            }
+            privateEndOfFile = false;
+            updateEndOfFile();
+            #else
+            (void)bytes;
+            privateError = ENOTSUP;
+            #endif
+        }
+
+        ///Close file stream automatically during destruction.
+        ~fileStream()
+        {
+            if(privateAtomic != nullptr and std::uncaught_exceptions() > 0)
+            {
+                //Data written before exception is likely incomplete.
+                rollback();
+            }
+            close();
+            delete privateArena;
+            delete privateChecksum;
+        }
+
+        /**Reopen file at the same path but in different mode.
         *Opening mode supports one of the 6 values. Those are:
         *1 - read only;
         *2 - write only;
         *3 - append only;
-        *4 - read and write, but file should exist;
-        *5 - read and write, but file will be created;
+        *4 - read and write, but file should exist;
+        *5 - read and write, but file will be created;
+        *6 - read and append.
+        *To choose whenever or not use binary mode use third bool parameter.
+        */
+        void reopen(unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        {
+            if(privateCompression != nullptr or privateAtomic != nullptr or privateMapping != nullptr)
+            {
+                //Compressed and mapped streams must be opened again with their settings.
+                privateError = ENOTSUP;
+                return;
+            }
+            if(!isStreamOpen())
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            synchronizeEncoding();
+            if(privateMemory != nullptr)
+            {
+                //Memory has no file to open again, so new C stream is made of its descriptor.
+                if(openingMode < 1 or openingMode > 6)
+                {
+                    privateError = errorCode;
+                    return;
+                }
+                const char* modes[] = {"r", "w", "a", "r+", "w+", "a+", "rb", "wb", "ab", "rb+", "wb+", "ab+"};
+                fclose(file);
+                file = privateMemory->stream(openingMode, modes[openingMode - 1 + ((binaryMode)?(6):(0))]);
+                if(file == nullptr)
+                {
+                    privateError = (errno != 0)?(errno):(errorCode);
+                    close();
+                    return;
+                }
+                privateBinaryMode = binaryMode;
+                privateMode = openingMode;
+                privateEndOfFile = false;
+                updateEndOfFile();
+                return;
+            }
+            std::string storage;
+            const char* native = nativePath(storage);
+            switch(openingMode)
+            {
+                default: privateError = errorCode; return;
+                case 1: file = freopen(native, (binaryMode)?("rb"):("r"), file); break;
+                case 2: file = freopen(native, (binaryMode)?("wb"):("w"), file); break;
+                case 3: file = freopen(native, (binaryMode)?("ab"):("a"), file); break;
+                case 4: file = freopen(native, (binaryMode)?("rb+"):("r+"), file); break;
+                case 5: file = freopen(native, (binaryMode)?("wb+"):("w+"), file); break;
+                case 6: file = freopen(native, (binaryMode)?("ab+"):("a+"), file); break;
+            }
+            if(file == nullptr or isError())
+            {
+                privateError = extractError();
+                return;
+            }
+            if(openingMode == 2 or openingMode == 5)
+            {
+                dropLineIndex();
+            }
+            privateBinaryMode = binaryMode;
+            privateMode = openingMode;
+            privateEndOfFile = false;
+            updateEndOfFile();
+        }
+
+        /**Function to read character, which supports binary mode.
+        *You can specify type for read characters(char, char16_t, char32_t) as following:
+        *fileStreamName.getCharacter<type>();
+        */
+        template<class char_type = char>
+        char_type getCharacter(int errorCode = defaultErrorCode)
+        {
+            if(!isValidForReading())
+            {
+                privateError = errorCode;
+                return '\0';
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            if(privateEncoding != nullptr)
+            {
+                //Code point can need more characters, which are returned by following calls.
+                fileEncodingState& state = *privateEncoding;
+                if(state.pendingPlace < state.pendingUnits.size())
+                {
+                    char_type unit = (char_type)state.pendingUnits[state.pendingPlace++];
+                    updateEndOfFile();
+                    return unit;
+                }
+                std::pmr::vector<char_type> units(currentResource());
+                if(!readEncoded(units, 1, false, errorCode))
+                {
+                    return '\0';
+                }
+                state.pendingUnits.assign(units.begin() + 1, units.end());
+                state.pendingPlace = 0;
+                privateEndOfFile = privateEndOfFile and state.pendingUnits.empty();
+                return units[0];
+            }
+            if(privateBinaryMode)
+            {
+                char_type data = readVariable<char_type>();
+                privateError = extractError();
+                if(isError())
+                {
+                    privateError = extractError();
+                    clearErrorPointing();
+                    return '\0';
+                }
+                updateEndOfFile();
+                return data;
+            }
+            else
+            {
+                char_type character = fgetc(file);
+                if(isError())
+                {
+                    privateError = extractError();
+                    clearErrorPointing();
+                    return '\0';
+                }
+                updateEndOfFile();
+                return character;
+            }
+        }
+
+        /**Reads specific amount of text. Places '\0' in the end of the string.
+        *You can specify type for read characters(char, char16_t, char32_t) as following:
+        *fileStreamName.getString<type>();
+        */
+        template<class char_type = char>
+        char_type* getString(size_t neededSize, int errorCode = defaultErrorCode)
+        {
+            if(!isValidForReading())
+            {
+                privateError = errorCode;
+                return emptyString<char_type>();
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            std::pmr::vector<char_type> line(currentResource());
+            if(privateEncoding != nullptr)
+            {
+                return (readEncoded(line, neededSize, false, errorCode))?(finishString(line)):(emptyString<char_type>());
+            }
+            for(size_t i = 0; i < neededSize and !privateEndOfFile; ++i)
+            {
+                char_type checkedCharacter = getCharacter<char_type>();
+                if(checkedCharacter == '\0')
+                {
+                    //privateError = errorCode; //Error already tracked.
+                    return emptyString<char_type>();
+                }
+                line.push_back(checkedCharacter);
+            }
+            return finishString(line);
+        }
+
+        /**Gets line of file. Assumes, that pointer placed at the start of the line. Replaces '\n' in the end with '\0'.
+        *You can specify type for read characters(char, char16_t, char32_t) as following:
+        *fileStreamName.getLine<type>();
+        */
+        template<class char_type = char>
+        char_type* getLine(int errorCode = defaultErrorCode)
+        {
+            if(!isValidForReading())
+            {
+                privateError = errorCode;
+                return emptyString<char_type>();
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            std::pmr::vector<char_type> line(currentResource());
+            if(privateEncoding != nullptr)
+            {
+                return (readEncoded(line, SIZE_MAX, true, errorCode))?(finishString(line)):(emptyString<char_type>());
+            }
+            while(true)
+            {
+                char_type checkedCharacter = getCharacter<char_type>();
+                if(checkedCharacter == '\0')
+                {
+                    //privateError = errorCode; //Error already tracked.
+                    return emptyString<char_type>();
+                }
+                if(checkedCharacter == '\n')
+                {
+                    break;
+                }
+                line.push_back(checkedCharacter);
+            }
+            return finishString(line);
+        }
+
+        /**Gets all content of the file.
+        *You can specify type for read characters(char, char16_t, char32_t) as following:
+        *fileStreamName.getFile<type>();
+        */
+        template<class char_type = char>
+        char_type* getFile(int errorCode = defaultErrorCode)
+        {
+            if(!isValidForReading())
+            {
+                privateError = errorCode;
+                return emptyString<char_type>();
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            std::pmr::vector<char_type> line(currentResource());
+            if(privateEncoding != nullptr)
+            {
+                return (readEncoded(line, SIZE_MAX, false, errorCode))?(finishString(line)):(emptyString<char_type>());
+            }
+            while(!privateEndOfFile)
+            {
+                char_type checkedCharacter = getCharacter<char_type>();
+                if(checkedCharacter == '\0')
+                {
+                    //privateError = errorCode; //Error already tracked.
+                    return emptyString<char_type>();
+                }
+                line.push_back(checkedCharacter);
+            }
+            return finishString(line);
+        }
+
+        /**Function to write character, which supports binary mode.
+        *You can specify type for written characters(char, char16_t, char32_t).
+        *The syntax is following:
+        *fileStreamName.writeCharacter<type>(character to add);
+        */
+        template<class char_type = char>
+        void writeCharacter(const char_type character, int errorCode = defaultErrorCode)
+        {
+            if(!isValidForWriting())
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex();
+            if(privateEncoding != nullptr and (sizeof(char_type) != 1 or privateEncoding->encoding != 1))
+            {
+                writeEncoded(&character, 1, false, errorCode);
+                return;
+            }
+            synchronizeEncoding();
+            if(privateBinaryMode)
+            {
+                writeVariable(character);
+                if(isError())
+                {
+                    privateError = extractError();
+                    clearErrorPointing();
+                    return;
+                }
+            }
+            else
+            {
+                fputc(character, file);
+                if(isError())
+                {
+                    privateError = extractError();
+                    clearErrorPointing();
+                    return;
+                }
+            }
+            updateEndOfFile(); //Only character function needs that.
+        }
+
+        /**Function to write string to file, which supports binary mode.
+        *You can specify type for written characters(char, char16_t, char32_t).
+        *The syntax is following:
+        *fileStreamName.writeString<type>(string to add, expected size(unnecessary));
+        */
+        template<class char_type = char>
+        void writeString(const char_type* const& string, size_t expectedSize = 0, int errorCode = defaultErrorCode)
+        {
+            if(!isValidForWriting() or (expectedSize != 0 and !isStringZeroTerminated(string, expectedSize)))
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex();
+            if(privateEncoding != nullptr)
+            {
+                writeEncoded(string, stringLength(string), false, errorCode);
+                return;
+            }
+            int savedError = privateError;
+            size_t stringPlace = 0;
+            while(string[stringPlace] != '\0')
+            {
+                writeCharacter<char_type>(string[stringPlace]);
+                if(privateError != savedError)
+                {
+                    return;
+                }
+                ++stringPlace;
+            }
+        }
+
+        /**Function to write line, which supports binary mode.
+        *After writing line, goes to next line.
+        *You can specify type for written characters(char, char16_t, char32_t).
+        *The syntax is following:
+        *fileStreamName.writeLine<type>(string to add, expected size(unnecessary));
+        */
+        template<class char_type = char>
+        void writeLine(const char_type* const& string, size_t expectedSize = 0, int errorCode = defaultErrorCode)
+        {
+            if(!isValidForWriting() or (expectedSize != 0 and !isStringZeroTerminated(string, expectedSize)))
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex();
+            if(privateEncoding != nullptr)
+            {
+                writeEncoded(string, stringLength(string), true, errorCode);
+                return;
+            }
+            int savedError = privateError;
+            size_t stringPlace = 0;
+            while(string[stringPlace] != '\0')
+            {
+                writeCharacter<char_type>(string[stringPlace]);
+                if(privateError != savedError)
+                {
+                    return;
+                }
+                ++stringPlace;
+            }
+            writeCharacter('\n');
+            if(privateError != savedError)
+            {
+                return;
+            }
+        }
+
+        /**Function, which resets file to zero position.
+        *Syntax is following:
+        *fileStreamName.reset()
+        */
+        void reset(int errorCode = defaultErrorCode)
+        {
+            if(privateMode == 3 or !isStreamOpen())
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            privateEndOfFile = false;
+            if(privateMapping != nullptr)
+            {
+                privateMapping->position = 0;
+                updateEndOfFile();
+                return;
+            }
+            synchronizeEncoding();
+            rewind(file);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            updateEndOfFile();
+        }
+
+        /**Function, which will attempt to move pointer to choosen place.
+        *Syntax is following:
+        *fileStreamName.pointTo(place in file, from where to start)
+        *We can start from the:
+        *1 - start;
+        *2 - current position;
+        *3 - end position.
+        *If your system supports so you can use:
+        *4 - SEEK_DATA;
+        *5 - SEEK_HOLE.
+        */
+        void pointTo(int pointer, unsigned short from = 1, int errorCode = defaultErrorCode)
+        {
+            if(privateMode == 3 or !isStreamOpen())
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            if(privateMapping != nullptr)
+            {
+                std::int64_t base = (from == 1)?(0):((from == 2)?((std::int64_t)privateMapping->position):((std::int64_t)privateMapping->size));
+                if(from < 1 or from > 3 or base + pointer < 0)
+                {
+                    privateError = (from >= 1 and from <= 3)?(EINVAL):(errorCode);
+                    return;
+                }
+                privateMapping->position = (std::uint64_t)(base + pointer);
+                privateEndOfFile = false;
+                updateEndOfFile();
+                return;
+            }
+            synchronizeEncoding();
+            int errorCheck = 0;
+            switch(from)
+            {
+                default: privateError = errorCode; return;
+                case 1: errorCheck = fseek(file, pointer, SEEK_SET); break;
+                case 2: errorCheck = fseek(file, pointer, SEEK_CUR); break;
+                case 3: errorCheck = fseek(file, pointer, SEEK_END); break;
+                #ifdef _GNU_SOURCE
+                case 4: errorCheck = fseek(file, pointer, SEEK_DATA); break;
+                case 5: errorCheck = fseek(file, pointer, SEEK_HOLE); break;
+                #endif
+            }
+
+            if(errorCheck != 0 or isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            privateEndOfFile = false;
+            updateEndOfFile();
+        }
+
+        ///Returns size of a file.
+        size_t size(int errorCode = defaultErrorCode)
+        {
+            if(privateMode == 3 or !isStreamOpen())
+            {
+                privateError = errorCode;
+                return 0;
+            }
+            if(privateMapping != nullptr)
+            {
+                return (size_t)privateMapping->size;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            size_t current = ftell(file);
+            fseek(file, 0, SEEK_END);
+            size_t returned = ftell(file);
+            fseek(file, current, SEEK_SET);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return 0;
+            }
+            return returned;
+        }
+
+        /**Function which reads in fprintf/fscanf format. Requires pointers to variables, not variables itself.
+        *You can specify type for format characters(char, char16_t, char32_t).
+        *Syntax is following:
+        *fileStreamName.getBtFormat<type>(format, pointers to all variables to which result will be written);
+        */
+        template<class char_type = char, class... Arguments>
+        int getByFormat(const char_type* const& format, Arguments*... arguments)
+        {
+            //if(!isValidForTextReading())
+            if(!isValidForReading())
+            {
+                privateError = defaultErrorCode;
+                return 0;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            synchronizeEncoding();
+            //If format strings can be influenced by an attacker, they can be exploited (CWE-134). Use a constant for the format specification.
+            int processedInt = fscanf(file, format, arguments...);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return privateError;
+            }
+            updateEndOfFile();
+            if(processedInt < 0)
+            {
+                privateError = (unsigned short)processedInt;
+                return 0;
+            }
+            else if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return privateError;
+            }
+            else
+            {
+                return processedInt;
+            }
+        }
+
+        /**Function which writes in fprintf/fscanf format. Requires variables.
+        *You can specify type for format characters(char, char16_t, char32_t).
+        *Syntax is following:
+        *fileStreamName.writeByFormat<type>(format, pointers to all variables values of which will be written);
+        */
+        template<class char_type = char, class... Arguments>
+        int writeByFormat(const char_type* const& format, Arguments... arguments)
+        {
+            //if(!isValidForTextWriting())
+            if(!isValidForWriting())
+            {
+                privateError = defaultErrorCode;
+                return 0;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex();
+            synchronizeEncoding();
+            //If format strings can be influenced by an attacker, they can be exploited (CWE-134). Use a constant for the format specification.
+            int processedInt = fprintf(file, format, arguments...);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return privateError;
+            }
+            updateEndOfFile();
+            if(processedInt < 0)
+            {
+                privateError = (unsigned int)processedInt;
+                return 0;
+            }
+            else if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return privateError;
+            }
+            else
+            {
+                return processedInt;
+            }
+        }
+
+        /**Function which reads in binary. Enforces for the type to be trivially copyable.
+        *Syntax is following:
+        *fileStreamName.readBlock<type of read value>(number of elements);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        type* readBlock(const size_t &count, size_t errorCode = defaultErrorCode)
+        {
+            if(count == 0)
+            {
+                privateError = ENOTSUP; //How I should allocate zero size array?
+                return nullptr;
+            }
+            if(!isValidForBinaryReading())
+            {
+                privateError = errorCode;
+                return nullptr;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            type* pointer = allocate<type>(count);
+            if(privateMapping != nullptr)
+            {
+                size_t copied = privateMapping->readAt(privateMapping->position, pointer, sizeof(type), count);
+                privateMapping->position += copied * sizeof(type);
+                updateChecksum(pointer, copied * sizeof(type));
+                updateEndOfFile();
+                if(copied == 0)
+                {
+                    privateError = errorCode;
+                    deallocate(pointer, count);
+                    return nullptr;
+                }
+                return pointer;
+            }
+            size_t result = fread(pointer, sizeof(type), count, file);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                deallocate(pointer, count);
+                return nullptr;
+            }
+            updateChecksum(pointer, result * sizeof(type));
+            updateEndOfFile();
+            if(result == 0 or isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                deallocate(pointer, count);
+                return nullptr;
+            }
+            return pointer;
+        }
+
+        /**Function which reads in binary into existing array, without allocation. Enforces for the type to be trivially copyable.
+        *Returns amount of read elements, which is smaller than requested at the end of file.
+        *Syntax is following:
+        *fileStreamName.readBlockInto<type of read value>(pointer to array, number of elements);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        size_t readBlockInto(type* pointer, size_t count, size_t errorCode = defaultErrorCode)
+        {
+            if(!isValidForBinaryReading() or pointer == nullptr)
+            {
+                privateError = errorCode;
+                return 0;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            if(privateMapping != nullptr)
+            {
+                size_t copied = privateMapping->readAt(privateMapping->position, pointer, sizeof(type), count);
+                privateMapping->position += copied * sizeof(type);
+                updateChecksum(pointer, copied * sizeof(type));
+                updateEndOfFile();
+                return copied;
+            }
+            size_t result = fread(pointer, sizeof(type), count, file);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+            }
+            updateChecksum(pointer, result * sizeof(type));
+            updateEndOfFile();
+            return result;
+        }
+
+        /**Function which reads in binary. Enforces for the type to be trivially copyable.
+        *Syntax is following:
+        *fileStreamName.readVariable<type of read value>();
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        type readVariable(size_t errorCode = defaultErrorCode)
+        {
+            if(!isValidForBinaryReading())
+            {
+                privateError = errorCode;
+                return {};
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            type variable;
+            if(privateMapping != nullptr)
+            {
+                size_t copied = privateMapping->readAt(privateMapping->position, &variable, sizeof(type), 1);
+                privateMapping->position += copied * sizeof(type);
+                updateChecksum(&variable, copied * sizeof(type));
+                updateEndOfFile();
+                if(copied == 0)
+                {
+                    privateError = errorCode;
+                    return {};
+                }
+                return variable;
+            }
+            size_t result = fread(&variable, sizeof(type), 1, file);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return {};
+            }
+            updateChecksum(&variable, result * sizeof(type));
+            updateEndOfFile();
+            if(result == 0 or isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return {};
+            }
+            return variable;
+        }
+
+        /**Function which writes in binary. Enforces for the type to be trivially copyable.
+        *Syntax is following:
+        *fileStreamName.writeBlock<type of written value, unnecessary>(pointer to written element, number of elements);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        void writeBlock(type* pointer, size_t count, size_t errorCode = defaultErrorCode)
+        {
+            if(!isValidForBinaryWriting())
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex();
+            if(privateMapping != nullptr)
+            {
+                writeMapped(pointer, sizeof(type) * count, errorCode);
+                return;
+            }
+            size_t result = fwrite(pointer, sizeof(type), count, file);
+            updateChecksum(pointer, result * sizeof(type));
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            if(result == 0 or result != count)
+            {
+                privateError = errorCode;
+                return;
+            }
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            updateEndOfFile();
+        }
+
+        /**Function which writes in binary. Enforces for the type to be trivially copyable.
+        *Syntax is following:
+        *fileStreamName.writeVariable<type of written value, unnecessary>(written element);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        void writeVariable(const type &variable, size_t errorCode = defaultErrorCode)
+        {
+            if(!isValidForBinaryWriting())
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex();
+            if(privateMapping != nullptr)
+            {
+                writeMapped(&variable, sizeof(type), errorCode);
+                return;
+            }
+            size_t result = fwrite(&variable, sizeof(type), 1, file);
+            updateChecksum(&variable, result * sizeof(type));
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            if(result != 1)
+            {
+                privateError = errorCode;
+                return;
+            }
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            updateEndOfFile();
+        }
+
+        /**Function which writes in binary at choosen place, without moving position of stream. Enforces for the type to be trivially copyable.
+        *Mapped streams copy directly into mapping, others seek there and back. Not available in append modes.
+        *Syntax is following:
+        *fileStreamName.writeAt<type of written value, unnecessary>(place in bytes, pointer to written element, number of elements);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        void writeAt(std::uint64_t place, const type* pointer, size_t count, size_t errorCode = defaultErrorCode)
+        {
+            if(!isValidForBinaryWriting() or pointer == nullptr or privateMode == 3 or privateMode == 6 or privateCompression != nullptr)
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex(place);
+            if(privateMapping != nullptr)
+            {
+                if(!privateMapping->writeAt(place, pointer, sizeof(type) * count))
+                {
+                    privateError = (errno != 0)?(errno):((int)errorCode);
+                    errno = 0;
+                    return;
+                }
+                updateEndOfFile();
+                return;
+            }
+            long saved = ftell(file);
+            if(saved < 0 or fseek(file, (long)place, SEEK_SET) != 0)
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            bool succeeded = writeBytes(pointer, sizeof(type) * count, errorCode);
+            fseek(file, saved, SEEK_SET);
+            if(succeeded)
+            {
+                updateEndOfFile();
+            }
+        }
+
+        /**Function which reads in binary from choosen place, without moving position of stream. Enforces for the type to be trivially copyable.
+        *Returns amount of read elements, which is smaller than requested at the end of file.
+        *Syntax is following:
+        *fileStreamName.readAt<type of read value>(place in bytes, pointer to array, number of elements);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        size_t readAt(std::uint64_t place, type* pointer, size_t count, size_t errorCode = defaultErrorCode)
+        {
+            if(!isStreamOpen() or !privateBinaryMode or pointer == nullptr or privateMode == 2 or privateMode == 3 or privateCompression != nullptr)
+            {
+                privateError = errorCode;
+                return 0;
+            }
+            if(privateMapping != nullptr)
+            {
+                return privateMapping->readAt(place, pointer, sizeof(type), count);
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            long saved = ftell(file);
+            if(saved < 0 or fseek(file, (long)place, SEEK_SET) != 0)
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return 0;
+            }
+            size_t result = fread(pointer, sizeof(type), count, file);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+            }
+            fseek(file, saved, SEEK_SET);
+            return result;
+        }
+
+    private:
+        ///Size of buffer used for converting ordered blocks and records.
+        const static size_t conversionBufferSize = 65536;
+
+        /**Moves stream kept in memory into its spill file once its size passes threshold. Stream continues at the same place.
+        *Only writing makes memory bigger, so reading and seeking past threshold don't move it.
+        */
+        void spillMemory()
+        {
+            #ifdef LIBFILESTREAM_POSIX
+            fileMemoryState& memory = *privateMemory;
+            //Writing makes size bigger than threshold only if it ends past threshold, so buffer is flushed and size checked only then.
+            long position = ftell(file);
+            if(!isValidForWriting() or position < 0 or (std::uint64_t)position <= memory.spillThreshold)
+            {
+                return;
+            }
+            struct stat status;
+            if(fflush(file) != 0 or fstat(memory.descriptor, &status) != 0 or (std::uint64_t)status.st_size <= memory.spillThreshold)
+            {
+                return;
+            }
+            //Failed spilling isn't tried again, stream stays in memory.
+            memory.spillThreshold = 0;
+            FILE* spilled = fopen(memory.spillPath.c_str(), "wb");
+            if(spilled == nullptr)
+            {
+                privateError = (errno != 0)?(errno):(defaultErrorCode);
+                return;
+            }
+            std::vector<char> buffer(1 << 20);
+            off_t copied = 0;
+            bool succeeded = true;
+            while(succeeded)
+            {
+                ssize_t result = pread(memory.descriptor, buffer.data(), buffer.size(), copied);
+                if(result < 0 and errno == EINTR)
+                {
+                    continue;
+                }
+                if(result <= 0)
+                {
+                    succeeded = result == 0;
+                    break;
+                }
+                succeeded = fwrite(buffer.data(), 1, (size_t)result, spilled) == (size_t)result;
+                copied += result;
+            }
+            succeeded = (fclose(spilled) == 0) and succeeded;
+            //Spill file exists now, so it is opened without truncation in mode allowing the same functions.
+            const char* modes[] = {"r", "r+", "a", "r+", "r+", "a+", "rb", "rb+", "ab", "rb+", "rb+", "ab+"};
+            spilled = (succeeded)?(fopen(memory.spillPath.c_str(), modes[privateMode - 1 + ((privateBinaryMode)?(6):(0))])):(nullptr);
+            if(spilled != nullptr and privateMode != 3 and privateMode != 6 and fseek(spilled, position, SEEK_SET) != 0)
+            {
+                fclose(spilled);
+                spilled = nullptr;
+            }
+            if(spilled == nullptr)
+            {
+                privateError = (errno != 0)?(errno):(defaultErrorCode);
+                remove(memory.spillPath.c_str());
+                return;
+            }
+            std::basic_string<path_type> spilledPath;
+            if constexpr(std::is_same<path_type, char>::value)
+            {
+                spilledPath = memory.spillPath;
+            }
+            else if(!decodePath(memory.spillPath, spilledPath))
+            {
+                spilledPath.clear();
+            }
+            fclose(file);
+            file = spilled;
+            memory.close();
+            delete privateMemory;
+            privateMemory = nullptr;
+            releasePath();
+            storePath(spilledPath.c_str(), spilledPath.size());
+            #endif
+        }
+
+        ///Gives read but not transcoded bytes back to C stream, so functions not using encoding layer continue at the right place.
+        void synchronizeEncoding()
+        {
+            if(privateEncoding == nullptr)
+            {
+                return;
+            }
+            if(privateEncoding->unused() != 0)
+            {
+                fseek(file, -(long)privateEncoding->unused(), SEEK_CUR);
+            }
+            privateEncoding->rawPlace = privateEncoding->rawSize = 0;
+            privateEncoding->sourceEnd = false;
+            privateEncoding->pendingUnits.clear();
+            privateEncoding->pendingPlace = 0;
+        }
+
+        /**Reads text through encoding layer. Stops after limit code points, or after new line if stopAtNewLine is true.
+        *Returns false if nothing was read or on error.
+        */
+        template<class char_type>
+        bool readEncoded(std::pmr::vector<char_type>& line, size_t limit, bool stopAtNewLine, int errorCode)
+        {
+            fileEncodingState& state = *privateEncoding;
+            bool anything = state.pendingPlace < state.pendingUnits.size();
+            for(; state.pendingPlace < state.pendingUnits.size(); ++state.pendingPlace)
+            {
+                line.push_back((char_type)state.pendingUnits[state.pendingPlace]);
+            }
+            while(limit > 0)
+            {
+                if(state.unused() != 0)
+                {
+                    size_t consumed = 0;
+                    bool foundNewLine = false;
+                    bool valid = state.transcode<char_type>(state.raw.data() + state.rawPlace, state.unused(), line, consumed, limit, stopAtNewLine, foundNewLine);
+                    state.rawPlace += consumed;
+                    anything = anything or consumed != 0;
+                    if(!valid)
+                    {
+                        privateError = EILSEQ;
+                        return false;
+                    }
+                    if(foundNewLine or limit == 0)
+                    {
+                        break;
+                    }
+                    if(state.unused() != 0 and state.sourceEnd)
+                    {
+                        //File ends inside of code point.
+                        privateError = EILSEQ;
+                        return false;
+                    }
+                }
+                else if(state.sourceEnd)
+                {
+                    break;
+                }
+                if(!state.fill(file))
+                {
+                    privateError = extractError();
+                    clearErrorPointing();
+                    return false;
+                }
+            }
+            //Reading ahead finds end of file without seeking.
+            if(state.unused() == 0 and !state.sourceEnd and !state.fill(file))
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return false;
+            }
+            privateEndOfFile = state.unused() == 0 and state.sourceEnd;
+            if(!anything)
+            {
+                privateError = errorCode;
+                return false;
+            }
+            return true;
+        }
+
+        ///Writes text through encoding layer.
+        template<class char_type>
+        void writeEncoded(const char_type* text, size_t length, bool newLine, int errorCode)
+        {
+            synchronizeEncoding();
+            std::vector<unsigned char> bytes;
+            const char_type lineEnd = '\n';
+            if(!privateEncoding->encodeText(text, length, bytes) or (newLine and !privateEncoding->encodeText(&lineEnd, 1, bytes)))
+            {
+                privateError = EILSEQ;
+                return;
+            }
+            if(!bytes.empty() and fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size())
+            {
+                privateError = (isError())?(extractError()):(errorCode);
+                clearErrorPointing();
+                return;
+            }
+            updateEndOfFile();
+        }
+
+        ///Updates attached checksum with bytes passing through stream.
+        void updateChecksum(const void* data, size_t byteCount)
+        {
+            if(privateChecksum != nullptr and byteCount != 0)
+            {
+                privateChecksum->update(data, byteCount);
+            }
+        }
+
+        ///Copies bytes into mapping at position of stream. Returns true on success.
+        bool writeMapped(const void* data, size_t byteCount, size_t errorCode)
+        {
+            errno = 0;
+            if(!privateMapping->writeAt(privateMapping->position, data, byteCount))
+            {
+                privateError = (errno != 0)?(errno):((int)errorCode);
+                errno = 0;
+                return false;
+            }
+            privateMapping->position += byteCount;
+            updateChecksum(data, byteCount);
+            updateEndOfFile();
+            return true;
+        }
+
+        ///Writes raw bytes. Returns true on success.
+        bool writeBytes(const void* data, size_t byteCount, size_t errorCode)
+        {
+            if(privateMapping != nullptr)
+            {
+                return writeMapped(data, byteCount, errorCode);
+            }
+            size_t result = fwrite(data, 1, byteCount, file);
+            updateChecksum(data, result);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return false;
+            }
+            if(result != byteCount)
+            {
+                privateError = errorCode;
+                return false;
+            }
+            return true;
+        }
+
+        ///Reads exactly choosen amount of raw bytes. Returns true on success.
+        bool readBytes(void* data, size_t byteCount, size_t errorCode)
+        {
+            if(privateMapping != nullptr)
+            {
+                if(byteCount != 0 and privateMapping->readAt(privateMapping->position, data, byteCount, 1) != 1)
+                {
+                    privateError = errorCode;
+                    return false;
+                }
+                privateMapping->position += byteCount;
+                updateChecksum(data, byteCount);
+                return true;
+            }
+            size_t result = fread(data, 1, byteCount, file);
+            updateChecksum(data, result);
+            if(isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return false;
+            }
+            if(result != byteCount)
+            {
+                privateError = errorCode;
+                return false;
+            }
+            return true;
+        }
+
+    public:
+        /**Function which writes number in choosen byte order.
+        *Byte order supports one of the 2 values: 1 - little endian; 2 - big endian.
+        *Syntax is following:
+        *fileStreamName.writeOrdered<type of written value, unnecessary>(written element, byte order);
+        */
+        template<class type>
+        void writeOrdered(const type& variable, unsigned short order = fileByteOrder::little, size_t errorCode = defaultErrorCode)
+        {
+            writeOrderedBlock<type>(&variable, 1, order, errorCode);
+        }
+
+        /**Function which reads number stored in choosen byte order.
+        *Byte order supports one of the 2 values: 1 - little endian; 2 - big endian.
+        *Syntax is following:
+        *fileStreamName.readOrdered<type of read value>(byte order);
+        */
+        template<class type>
+        type readOrdered(unsigned short order = fileByteOrder::little, size_t errorCode = defaultErrorCode)
+        {
+            static_assert(std::is_arithmetic<type>::value or std::is_enum<type>::value, "Only arithmetic and enumeration types have byte order.");
+            if(!fileByteOrder::isValid(order))
+            {
+                privateError = errorCode;
+                return {};
+            }
+            type variable = readVariable<type>(errorCode);
+            fileByteOrder::convertArray<type>(&variable, 1, order);
+            return variable;
+        }
+
+        /**Function which writes array of numbers in choosen byte order.
+        *If byte order is native, array is written directly without conversion.
+        *Syntax is following:
+        *fileStreamName.writeOrderedBlock<type of written value, unnecessary>(pointer to written element, number of elements, byte order);
+        */
+        template<class type>
+        void writeOrderedBlock(const type* pointer, size_t count, unsigned short order = fileByteOrder::little, size_t errorCode = defaultErrorCode)
+        {
+            static_assert(std::is_arithmetic<type>::value or std::is_enum<type>::value, "Only arithmetic and enumeration types have byte order.");
+            if(!isValidForBinaryWriting() or !fileByteOrder::isValid(order) or pointer == nullptr)
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex();
+            if(order == fileByteOrder::native)
+            {
+                if(!writeBytes(pointer, sizeof(type) * count, errorCode))
+                {
+                    return;
+                }
+                updateEndOfFile();
+                return;
+            }
+            const size_t chunk = (conversionBufferSize / sizeof(type) > 0)?(conversionBufferSize / sizeof(type)):(1);
+            const size_t bufferCount = (count < chunk)?(count):(chunk);
+            type* buffer = allocate<type>(bufferCount);
+            for(size_t done = 0; done < count;)
+            {
+                size_t part = (count - done < chunk)?(count - done):(chunk);
+                copyList<type>(pointer + done, buffer, part);
+                fileByteOrder::convertArray<type>(buffer, part, order);
+                if(!writeBytes(buffer, sizeof(type) * part, errorCode))
+                {
+                    deallocate(buffer, bufferCount);
+                    return;
+                }
+                done += part;
+            }
+            deallocate(buffer, bufferCount);
+            updateEndOfFile();
+        }
+
+        /**Function which reads array of numbers stored in choosen byte order.
+        *If byte order is native, array is returned directly without conversion.
+        *Syntax is following:
+        *fileStreamName.readOrderedBlock<type of read value>(number of elements, byte order);
+        */
+        template<class type>
+        type* readOrderedBlock(const size_t &count, unsigned short order = fileByteOrder::little, size_t errorCode = defaultErrorCode)
+        {
+            static_assert(std::is_arithmetic<type>::value or std::is_enum<type>::value, "Only arithmetic and enumeration types have byte order.");
+            if(!fileByteOrder::isValid(order))
+            {
+                privateError = errorCode;
+                return nullptr;
+            }
+            type* pointer = readBlock<type>(count, errorCode);
+            if(pointer != nullptr)
+            {
+                fileByteOrder::convertArray<type>(pointer, count, order);
+            }
+            return pointer;
+        }
+
+        /**Function which writes record described by schema in single call.
+        *Syntax is following:
+        *fileStreamName.writeRecord<schema>(written record, byte order);
+        */
+        template<class schema>
+        void writeRecord(const typename schema::recordType& record, unsigned short order = fileByteOrder::little, size_t errorCode = defaultErrorCode)
+        {
+            writeRecords<schema>(&record, 1, order, errorCode);
+        }
+
+        /**Function which reads record described by schema in single call.
+        *Syntax is following:
+        *fileStreamName.readRecord<schema>(byte order);
+        */
+        template<class schema>
+        typename schema::recordType readRecord(unsigned short order = fileByteOrder::little, size_t errorCode = defaultErrorCode)
+        {
+            typename schema::recordType record{};
+            if(!isValidForBinaryReading() or !fileByteOrder::isValid(order))
+            {
+                privateError = errorCode;
+                return record;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            unsigned char buffer[schema::recordSize];
+            if(!readBytes(buffer, schema::recordSize, errorCode))
+            {
+                updateEndOfFile();
+                return {};
+            }
+            schema::unpack(buffer, record, order);
+            updateEndOfFile();
+            return record;
+        }
+
+        /**Function which writes array of records described by schema in one buffered pass.
+        *If schema matches layout in memory and byte order is native, array is written directly.
+        *Syntax is following:
+        *fileStreamName.writeRecords<schema>(pointer to first record, number of records, byte order);
+        */
+        template<class schema>
+        void writeRecords(const typename schema::recordType* records, size_t count, unsigned short order = fileByteOrder::little, size_t errorCode = defaultErrorCode)
+        {
+            if(!isValidForBinaryWriting() or !fileByteOrder::isValid(order) or records == nullptr)
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            invalidateLineIndex();
+            if(order == fileByteOrder::native and schema::isDirect())
+            {
+                if(!writeBytes(records, schema::recordSize * count, errorCode))
+                {
+                    return;
+                }
+                updateEndOfFile();
+                return;
+            }
+            const size_t chunk = (conversionBufferSize / schema::recordSize > 0)?(conversionBufferSize / schema::recordSize):(1);
+            const size_t bufferCount = (count < chunk)?(count):(chunk);
+            const size_t bufferSize = schema::recordSize * ((bufferCount > 0)?(bufferCount):(1));
+            unsigned char* buffer = allocate<unsigned char>(bufferSize);
+            for(size_t done = 0; done < count;)
+            {
+                size_t part = (count - done < chunk)?(count - done):(chunk);
+                for(size_t i = 0; i < part; ++i)
+                {
+                    schema::pack(records[done + i], buffer + i * schema::recordSize, order);
+                }
+                if(!writeBytes(buffer, schema::recordSize * part, errorCode))
+                {
+                    deallocate(buffer, bufferSize);
+                    return;
+                }
+                done += part;
+            }
+            deallocate(buffer, bufferSize);
+            updateEndOfFile();
+        }
+
+        /**Function which reads array of records described by schema in one buffered pass.
+        *If schema matches layout in memory and byte order is native, array is read directly.
+        *Syntax is following:
+        *fileStreamName.readRecords<schema>(number of records, byte order);
+        */
+        template<class schema>
+        typename schema::recordType* readRecords(const size_t &count, unsigned short order = fileByteOrder::little, size_t errorCode = defaultErrorCode)
+        {
+            using recordType = typename schema::recordType;
+            if(count == 0)
+            {
+                privateError = ENOTSUP; //Same as readBlock.
+                return nullptr;
+            }
+            if(!isValidForBinaryReading() or !fileByteOrder::isValid(order))
+            {
+                privateError = errorCode;
+                return nullptr;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            recordType* records = allocate<recordType>(count);
+            if(order == fileByteOrder::native and schema::isDirect())
+            {
+                if(!readBytes(records, schema::recordSize * count, errorCode))
+                {
+                    deallocate(records, count);
+                    updateEndOfFile();
+                    return nullptr;
+                }
+                updateEndOfFile();
+                return records;
+            }
+            const size_t chunk = (conversionBufferSize / schema::recordSize > 0)?(conversionBufferSize / schema::recordSize):(1);
+            const size_t bufferSize = schema::recordSize * ((count < chunk)?(count):(chunk));
+            unsigned char* buffer = allocate<unsigned char>(bufferSize);
+            for(size_t done = 0; done < count;)
+            {
+                size_t part = (count - done < chunk)?(count - done):(chunk);
+                if(!readBytes(buffer, schema::recordSize * part, errorCode))
+                {
+                    deallocate(buffer, bufferSize);
+                    deallocate(records, count);
+                    updateEndOfFile();
+                    return nullptr;
+                }
+                for(size_t i = 0; i < part; ++i)
+                {
+                    schema::unpack(buffer + i * schema::recordSize, records[done + i], order);
+                }
+                done += part;
+            }
+            deallocate(buffer, bufferSize);
+            updateEndOfFile();
+            return records;
+        }
+
+    private:
+        ///Returns path of the line index sidecar.
+        std::string lineIndexPath() const
+        {
+            std::string storage;
+            const char* native = nativePath(storage);
+            return (native != nullptr)?(std::string(native) + ".lines"):(std::string());
+        }
+
+        ///Computes stamp of choosen indexed size, which is checksum of bytes before it. Returns false if they can't be read.
+        bool lineIndexStamp(std::uint64_t indexedSize, std::uint64_t& stamp)
+        {
+            size_t length = (indexedSize < fileLineIndex::stampSize)?((size_t)indexedSize):(fileLineIndex::stampSize);
+            stamp = 0;
+            if(length == 0)
+            {
+                return true;
+            }
+            std::string storage;
+            const char* native = nativePath(storage);
+            FILE* source = (native != nullptr)?(fopen(native, "rb")):(nullptr);
+            if(source == nullptr)
+            {
+                return false;
+            }
+            unsigned char buffer[fileLineIndex::stampSize];
+            bool succeeded = fseek(source, (long)(indexedSize - length), SEEK_SET) == 0 and fread(buffer, 1, length, source) == length;
+            fclose(source);
+            fileChecksumState checksum;
+            checksum.reset();
+            checksum.update(buffer, length);
+            stamp = checksum.digest();
+            return succeeded;
+        }
+
+        ///Drops line index and removes its sidecar.
+        void dropLineIndex()
+        {
+            delete privateLineIndex;
+            privateLineIndex = nullptr;
+            if(privateMemory == nullptr)
+            {
+                remove(lineIndexPath().c_str());
+            }
+        }
+
+        ///Drops line index and its sidecar if data before end of index is changed, because stored line starts could be wrong then.
+        void invalidateLineIndex(std::uint64_t place)
+        {
+            if(privateLineIndex != nullptr and place < privateLineIndex->indexedSize)
+            {
+                dropLineIndex();
+            }
+        }
+
+        ///Drops line index if writing at current place changes indexed data. Appending streams write only after it.
+        void invalidateLineIndex()
+        {
+            if(privateLineIndex != nullptr and privateMode != 3 and privateMode != 6)
+            {
+                invalidateLineIndex(point());
+            }
+        }
+
+        ///Returns real size of the file, works in any mode.
+        bool currentFileSize(std::uint64_t& fileSize)
+        {
+            if(privateMapping != nullptr)
+            {
+                fileSize = privateMapping->size;
+                return true;
+            }
+            if(privateMode != 1 and fflush(file) != 0)
+            {
+                return false;
+            }
+            std::string storage;
+            const char* native = nativePath(storage);
+            FILE* source = (native != nullptr)?(fopen(native, "rb")):(nullptr);
+            if(source == nullptr)
+            {
+                return false;
+            }
+            bool succeeded = fseek(source, 0, SEEK_END) == 0;
+            long result = ftell(source);
+            fclose(source);
+            fileSize = (std::uint64_t)result;
+            return succeeded and result >= 0;
+        }
+
+        /**Saves line index. Format is magic, interval, indexed size, amount of '\n', last character flag, amount of line starts and stamp as little endian 64 bit numbers.
+        *They are followed by differences between line starts, each stored as variable length number with 7 bits in byte.
+        */
+        bool saveLineIndex()
+        {
+            if(privateMemory != nullptr)
+            {
+                //Path of memory is not a directory entry, so index of memory isn't saved.
+                return true;
+            }
+            std::vector<unsigned char> deltas;
+            for(size_t i = 1; i < privateLineIndex->checkpoints.size(); ++i)
+            {
+                std::uint64_t delta = privateLineIndex->checkpoints[i] - privateLineIndex->checkpoints[i - 1];
+                while(delta >= 0x80)
+                {
+                    deltas.push_back((unsigned char)(delta | 0x80));
+                    delta >>= 7;
+                }
+                deltas.push_back((unsigned char)delta);
+            }
+            std::string indexPath = lineIndexPath();
+            fileStream<char> sidecar(indexPath.c_str(), 2, true);
+            if(!lineIndexStamp(privateLineIndex->indexedSize, privateLineIndex->stamp))
+            {
+                return false;
+            }
+            std::uint64_t header[7] = {0x32454E494C53464CULL, privateLineIndex->interval, privateLineIndex->indexedSize, privateLineIndex->newlines, privateLineIndex->endsWithNewline, privateLineIndex->checkpoints.size(), privateLineIndex->stamp};
+            sidecar.writeOrderedBlock(header, 7, fileByteOrder::little);
+            if(!deltas.empty())
+            {
+                sidecar.writeBlock(deltas.data(), deltas.size());
+            }
+            bool saved = sidecar.error == 0;
+            sidecar.close();
+            return saved;
+        }
+
+        ///Reads line index sidecar. Returns false if there is no valid one.
+        bool readLineIndex(fileLineIndex& loaded)
+        {
+            std::string indexPath = lineIndexPath();
+            fileStream<char> sidecar(indexPath.c_str(), 1, true);
+            if(sidecar.error != 0)
+            {
+                return false;
+            }
+            std::uint64_t* header = sidecar.template readOrderedBlock<std::uint64_t>(7, fileByteOrder::little);
+            if(header == nullptr or header[0] != 0x32454E494C53464CULL or header[1] == 0 or header[5] == 0)
+            {
+                delete[] header;
+                return false;
+            }
+            loaded.interval = header[1];
+            loaded.indexedSize = header[2];
+            loaded.newlines = header[3];
+            loaded.endsWithNewline = header[4] != 0;
+            std::uint64_t count = header[5];
+            loaded.stamp = header[6];
+            delete[] header;
+            loaded.checkpoints.assign(1, 0);
+            if(count > 1)
+            {
+                std::uint64_t place = sidecar.point();
+                std::uint64_t remaining = sidecar.size() - place;
+                unsigned char* deltas = (remaining > 0)?(sidecar.template readBlock<unsigned char>(remaining)):(nullptr);
+                if(deltas == nullptr)
+                {
+                    return false;
+                }
+                std::uint64_t delta = 0;
+                unsigned shift = 0;
+                for(std::uint64_t i = 0; i < remaining and shift < 64; ++i)
+                {
+                    delta |= (std::uint64_t)(deltas[i] & 0x7F) << shift;
+                    shift += 7;
+                    if((deltas[i] & 0x80) == 0)
+                    {
+                        loaded.checkpoints.push_back(loaded.checkpoints.back() + delta);
+                        delta = 0;
+                        shift = 0;
+                    }
+                }
+                delete[] deltas;
+            }
+            return loaded.checkpoints.size() == count;
+        }
+
+    public:
+        /**Builds line index of the file and saves it into sidecar file (path with ".lines" appended).
+        *Start of every interval-th line is stored. Large files are scanned by choosen amount of threads, 0 means all available.
+        *Index of stream kept in memory isn't saved, it lives only while stream is open.
+        *Writing into indexed part of file drops index and its sidecar, since line starts may move.
+        *Syntax is following:
+        *fileStreamName.buildLineIndex(interval, threads);
+        */
+        void buildLineIndex(size_t interval = 4096, unsigned threads = 0, int errorCode = defaultErrorCode)
+        {
+            std::uint64_t fileSize = 0;
+            if(!isStreamOpen() or privateCompression != nullptr or interval == 0 or !currentFileSize(fileSize))
+            {
+                privateError = (errno != 0)?(errno):(errorCode);
+                return;
+            }
+            std::string storage;
+            fileLineIndex* built = new fileLineIndex;
+            built->interval = interval;
+            threads = (threads != 0)?(threads):(std::thread::hardware_concurrency());
+            if(!built->extend(nativePath(storage), fileSize, threads))
+            {
+                delete built;
+                privateError = (errno != 0)?(errno):(errorCode);
+                return;
+            }
+            delete privateLineIndex;
+            privateLineIndex = built;
+            if(!saveLineIndex())
+            {
+                privateError = errorCode;
+            }
+        }
+
+        /**Loads line index from sidecar file. If file has grown since, index is extended.
+        *If file has shrunk or its last indexed bytes differ from the stored checksum, index is rebuilt. Returns false and sets ENOENT error if there is no valid sidecar.
+        */
+        bool loadLineIndex(int errorCode = defaultErrorCode)
+        {
+            if(!isStreamOpen() or privateCompression != nullptr)
+            {
+                privateError = errorCode;
+                return false;
+            }
+            if(privateMemory != nullptr)
+            {
+                privateError = ENOTSUP;
+                return false;
+            }
+            fileLineIndex* loaded = new fileLineIndex;
+            if(!readLineIndex(*loaded))
+            {
+                delete loaded;
+                privateError = ENOENT;
+                return false;
+            }
+            std::uint64_t fileSize = 0;
+            if(!currentFileSize(fileSize))
+            {
+                delete loaded;
+                privateError = (errno != 0)?(errno):(errorCode);
+                return false;
+            }
+            std::uint64_t stamp = 0;
+            bool rewritten = fileSize < loaded->indexedSize or !lineIndexStamp(loaded->indexedSize, stamp) or stamp != loaded->stamp;
+            delete privateLineIndex;
+            privateLineIndex = loaded;
+            if(fileSize != loaded->indexedSize or rewritten)
+            {
+                if(rewritten)
+                {
+                    //File was replaced or rewritten, old index is useless.
+                    size_t interval = loaded->interval;
+                    *loaded = fileLineIndex();
+                    loaded->interval = interval;
+                }
+                updateLineIndex(errorCode);
+            }
+            return privateLineIndex != nullptr;
+        }
+
+        /**Extends line index by lines appended since it was built and saves it.
+        *Called automatically on close of streams in modes 3 and 6.
+        */
+        void updateLineIndex(int errorCode = defaultErrorCode)
+        {
+            std::uint64_t fileSize = 0;
+            if(privateLineIndex == nullptr or !isStreamOpen())
+            {
+                privateError = errorCode;
+                return;
+            }
+            std::string storage;
+            if(!currentFileSize(fileSize) or !privateLineIndex->extend(nativePath(storage), fileSize, 1) or !saveLineIndex())
+            {
+                privateError = (errno != 0)?(errno):(errorCode);
+                delete privateLineIndex;
+                privateLineIndex = nullptr;
+            }
+        }
+
+        ///Returns amount of lines in indexed part of file. Requires built or loaded line index.
+        size_t lineCount(int errorCode = defaultErrorCode)
+        {
+            if(privateLineIndex == nullptr)
+            {
+                privateError = errorCode;
+                return 0;
+            }
+            return privateLineIndex->lines();
+        }
+
+        /**Moves pointer to the start of choosen line, counting from zero. Requires built or loaded line index.
+        *Syntax is following:
+        *fileStreamName.seekToLine(line number);
+        */
+        void seekToLine(size_t line, int errorCode = defaultErrorCode)
+        {
+            if(privateLineIndex == nullptr or privateMode == 3 or !isStreamOpen() or line >= privateLineIndex->lines())
+            {
+                privateError = errorCode;
+                return;
+            }
+            clearErrorPointing(); //Ensure that only own reports will be reported.
+            std::uint64_t place = privateLineIndex->checkpoints[line / privateLineIndex->interval];
+            std::uint64_t skipped = line % privateLineIndex->interval;
+            synchronizeEncoding();
+            //Line index is meant for large files, so pointTo with int offset isn't used.
+            if(fseek(file, (long)place, SEEK_SET) != 0)
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            char buffer[4096];
+            while(skipped > 0)
+            {
+                size_t result = fread(buffer, 1, sizeof(buffer), file);
+                if(result == 0)
+                {
+                    privateError = (isError())?(extractError()):(errorCode);
+                    clearErrorPointing();
+                    return;
+                }
+                for(size_t i = 0; i < result; ++i)
+                {
+                    if(buffer[i] == '\n' and --skipped == 0)
+                    {
+                        place += i + 1;
+                        break;
+                    }
+                }
+                if(skipped > 0)
+                {
+                    place += result;
+                }
+            }
+            if(fseek(file, (long)place, SEEK_SET) != 0 or isError())
+            {
+                privateError = extractError();
+                clearErrorPointing();
+                return;
+            }
+            privateEndOfFile = false;
+            updateEndOfFile();
+        }
+
+        ///Compare two file streams.
+        inline bool operator==(const fileStream& file) const
+        {
+            return (isStringsEqual(file.path, path) and (file.mode == mode) and (file.binary == binary));
+        }
+
+        ///Opens new file stream with the same parameters as old.
+        template<class type>
+        fileStream<type>& operator=(const fileStream<type>& file)
+        {
+            close();
+            if(file.path != nullptr and file.mode != 0)
+            {
+                open(file.path, file.mode, file.binary);
+            }
+            return *this;
+        }
+
+        template<typename type, typename = typename std::enable_if<std::is_trivial<type>::value && !std::is_same<type, std::string>::value>>
+        fileStream& operator<<(const type& written)
+        {
+            writeVariable(written);
+            return *this;
+        }
+
+        template<typename type, typename = typename std::enable_if<std::is_trivial<type>::value && !std::is_same<type, std::string>::value>>
+        fileStream& operator>>(type& read)
+        {
+            if(!isValidForBinaryReading())
+            {
+                privateError = defaultErrorCode;
+                read = {};
+                return *this;
+            }
+            read = readVariable<type>();
+            return *this;
+        }
+
+        // fileStream& operator>>(std::string& read)
+        // {
+            
+        // }
+
+        template<typename type>
+        fileStream& operator<<(const type* const& written)
+        {
+            writeString(written);
+            return *this;
+        }
+
+        // template<>
+        fileStream& operator<<(const std::string& written)
+        {
+            writeString(written.c_str());
+            return *this;
+        }
+
+        // template<>
+        fileStream& operator>>(std::string& read)
+        {
+            if(!isValidForReading())
+            {
+                return *this;
+            }
+            // const char divisionChars[] = "\n \t";
+            read.clear();
+            // char read = '\0';
+            // while(!end && !(read == '\n' || read == ' ' || read == '\t'))
+            // {
+            //     read = getCharacter();
+            //     written.push_back(read);
+            // }
+            for(char current = '\0'; !(current == '\n' || current == ' ' || current == '\t'); read = getCharacter()) read.push_back(current);
+            return *this;
+        }
+};
+
+#ifdef LIBFILESTREAM_POSIX
+/**
+ * Settings of group commit.
+ * Synchronization supports one of the 2 values:
+ * 1 - fdatasync;
+ * 2 - fsync.
+ */
+struct fileGroupCommitSettings
+{
+    ///Longest time in microseconds records wait before their batch is written.
+    unsigned long interval = 1000;
+
+    ///Amount of pending bytes, which causes batch to be written immediately.
+    size_t batchSize = 1 << 20;
+
+    ///Used synchronization.
+    unsigned short synchronization = 1;
+};
+
+/**
+ * Group commit over append stream.
+ * Writers add records and receive tickets. Background flusher writes all pending records with single writev,
+ * synchronizes them once and then completes all their tickets, so synchronization cost is shared by the batch.
+ * After failed batch, file is cut back to its size before the batch, so no part of failed records stays in it. If cutting fails too, file may end with part of the batch.
+ * Failed batch and all records added after it are never written, and append refuses new records, so stream must be closed and opened again.
+ * Use open to open file and close to close it. Functions are safe to call from several threads.
+ */
+struct fileGroupCommit
+{
+    protected:
+        fileStream<char> stream;
+
+        fileGroupCommitSettings privateSettings;
+
+        ///Error storage. Flusher reports into it while other threads read it.
+        std::atomic<int> privateError{0};
+
+        std::mutex guard;
+
+        ///Wakes flusher.
+        std::condition_variable pendingChanged;
+
+        ///Wakes writers waiting for tickets.
+        std::condition_variable durableChanged;
+
+        std::vector<std::string> pending;
+
+        size_t pendingSize = 0;
+
+        ///Last given ticket.
+        std::uint64_t lastTicket = 0;
+
+        ///Last ticket, which is written and synchronized.
+        std::uint64_t durableTicket = 0;
+
+        ///Ticket from which all records are lost because of error, 0 if none.
+        std::uint64_t failedTicket = 0;
+
+        bool stopping = false;
+
+        bool forced = false;
+
+        std::thread flusher;
+
+    private:
+        ///Writes whole batch, continuing after partial writes. Returns false and sets errno on failure.
+        static bool writeBatch(int descriptor, std::vector<std::string>& batch)
+        {
+            std::vector<iovec> vectors;
+            vectors.reserve(batch.size());
+            for(std::string& record : batch)
+            {
+                if(!record.empty())
+                {
+                    vectors.push_back({&record[0], record.size()});
+                }
+            }
+            #ifdef IOV_MAX
+            const size_t vectorLimit = IOV_MAX;
+            #else
+            const size_t vectorLimit = 16; //Smallest limit allowed by POSIX.
+            #endif
+            size_t first = 0;
+            while(first < vectors.size())
+            {
+                int count = (int)((vectors.size() - first < vectorLimit)?(vectors.size() - first):(vectorLimit));
+                ssize_t written = writev(descriptor, vectors.data() + first, count);
+                if(written < 0)
+                {
+                    if(errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                size_t remaining = (size_t)written;
+                while(first < vectors.size() and remaining >= vectors[first].iov_len)
+                {
+                    remaining -= vectors[first].iov_len;
+                    ++first;
+                }
+                if(remaining > 0)
+                {
+                    vectors[first].iov_base = static_cast<char*>(vectors[first].iov_base) + remaining;
+                    vectors[first].iov_len -= remaining;
+                }
+            }
+            return true;
+        }
+
+        void flushLoop()
+        {
+            std::unique_lock<std::mutex> lock(guard);
+            while(true)
+            {
+                pendingChanged.wait(lock, [this]()
+                {
+                    return stopping or forced or !pending.empty();
+                });
+                //Batch is collected from its first record until interval passes or batch is big enough.
+                pendingChanged.wait_for(lock, std::chrono::microseconds(privateSettings.interval), [this]()
+                {
+                    return stopping or forced or pendingSize >= privateSettings.batchSize;
+                });
+                if(pending.empty())
+                {
+                    forced = false;
+                    durableChanged.notify_all();
+                    if(stopping)
+                    {
+                        return;
+                    }
+                    continue;
+                }
+                std::vector<std::string> batch;
+                batch.swap(pending);
+                pendingSize = 0;
+                forced = false;
+                std::uint64_t batchTicket = lastTicket;
+                if(failedTicket != 0)
+                {
+                    //Records after failed ones are dropped, so retried records can't be written twice.
+                    durableChanged.notify_all();
+                    continue;
+                }
+                lock.unlock();
+                int descriptor = fileno(stream.file);
+                struct stat information;
+                bool measured = fstat(descriptor, &information) == 0;
+                bool succeeded = writeBatch(descriptor, batch) and fileDurability::synchronize(descriptor, privateSettings.synchronization);
+                int savedError = errno;
+                if(!succeeded and measured)
+                {
+                    //Torn record mustn't stay in file, since its ticket is reported as failed.
+                    while(ftruncate(descriptor, information.st_size) != 0 and errno == EINTR);
+                }
+                lock.lock();
+                if(succeeded)
+                {
+                    durableTicket = batchTicket;
+                }
+                else if(failedTicket == 0)
+                {
+                    failedTicket = batchTicket - batch.size() + 1;
+                    privateError = (savedError != 0)?(savedError):(fileStream<char>::defaultErrorCode);
+                }
+                durableChanged.notify_all();
+            }
+        }
+
+    public:
+        ///Last error storage. Uneditable from outside.
+        const std::atomic<int> &error = privateError;
+
+        fileGroupCommit() = default;
+
+        fileGroupCommit(const fileGroupCommit&) = delete;
+
+        /**Opens append stream with group commit.
+        *Opening mode supports one of the 2 values. Those are:
+        *3 - append only;
         *6 - read and append.
-        *To choose whenever or not use binary mode use third bool parameter.
         */
-        void reopen(unsigned short openingMode, bool binaryMode = false, int errorCode = defaultErrorCode)
+        void open(const char* choosenPath, unsigned short openingMode = 3, bool binaryMode = false, const fileGroupCommitSettings& settings = fileGroupCommitSettings(), int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            if(stream.isStreamOpen() or (openingMode != 3 and openingMode != 6) or (settings.synchronization != 1 and settings.synchronization != 2))
+            {
+                privateError = errorCode;
+                return;
+            }
+            stream.open(choosenPath, openingMode, binaryMode, errorCode);
+            if(stream.error != 0)
+            {
+                privateError = stream.getError();
+                return;
+            }
+            privateSettings = settings;
+            stopping = false;
+            lastTicket = durableTicket = failedTicket = 0;
+            flusher = std::thread(&fileGroupCommit::flushLoop, this);
+        }
+
+        /**Adds record to the end of file. Returns ticket, which becomes durable after record is written and synchronized.
+        *Returns 0 if stream isn't open or writing of earlier batch failed, error then keeps error of the batch.
+        */
+        std::uint64_t append(const void* data, size_t size, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            if(failedTicket != 0)
+            {
+                return 0;
+            }
+            if(!stream.isStreamOpen() or stopping or (data == nullptr and size != 0))
+            {
+                privateError = errorCode;
+                return 0;
+            }
+            pending.emplace_back(static_cast<const char*>(data), size);
+            pendingSize += size;
+            ++lastTicket;
+            if(pending.size() == 1 or pendingSize >= privateSettings.batchSize)
+            {
+                pendingChanged.notify_one();
+            }
+            return lastTicket;
+        }
+
+        ///Adds line to the end of file. Returns ticket, see append.
+        std::uint64_t appendLine(const char* line, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            if(line == nullptr)
+            {
+                privateError = errorCode;
+                return 0;
+            }
+            std::string record = line;
+            record.push_back('\n');
+            return append(record.data(), record.size(), errorCode);
+        }
+
+        ///Checks whenever record of ticket is written and synchronized.
+        bool isDurable(std::uint64_t ticket)
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            return ticket != 0 and ticket <= durableTicket and (failedTicket == 0 or ticket < failedTicket);
+        }
+
+        ///Waits until record of ticket is written and synchronized. Returns false if it failed.
+        bool wait(std::uint64_t ticket)
+        {
+            std::unique_lock<std::mutex> lock(guard);
+            if(ticket == 0 or ticket > lastTicket)
+            {
+                return false;
+            }
+            durableChanged.wait(lock, [this, ticket]()
+            {
+                return ticket <= durableTicket or (failedTicket != 0 and ticket >= failedTicket);
+            });
+            return ticket <= durableTicket and (failedTicket == 0 or ticket < failedTicket);
+        }
+
+        ///Writes pending records immediately and waits for them. Returns false if any failed.
+        bool flush()
+        {
+            std::uint64_t ticket = 0;
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                ticket = lastTicket;
+                forced = true;
+                pendingChanged.notify_one();
+            }
+            return ticket == 0 or wait(ticket);
+        }
+
+        ///Writes pending records and closes stream.
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                stopping = true;
+                pendingChanged.notify_one();
+            }
+            if(flusher.joinable())
+            {
+                flusher.join();
+            }
+            stream.close();
+        }
+
+        ///Close group commit automatically during destruction.
+        ~fileGroupCommit()
+        {
+            close();
+        }
+};
+#endif
+
+/**
+ * Counters of logger. Latencies are measured inside write calls, in nanoseconds.
+ */
+struct fileLoggerStatistics
+{
+    ///Amount of accepted records.
+    std::uint64_t enqueued = 0;
+
+    ///Amount of records dropped because queue was full.
+    std::uint64_t dropped = 0;
+
+    ///Amount of records stored outside of full queue.
+    std::uint64_t grown = 0;
+
+    ///Amount of times writer waited for free space.
+    std::uint64_t blocked = 0;
+
+    ///Amount of batches written into file.
+    std::uint64_t batches = 0;
+
+    ///Sum of time spent in accepted write calls.
+    std::uint64_t totalEnqueueLatency = 0;
+
+    ///Longest time spent in write call.
+    std::uint64_t maxEnqueueLatency = 0;
+};
+
+/**
+ * Logger writing records of many threads into one append stream.
+ * Writers place preformatted records into lock-free queue. Single background thread takes them out and writes them in large batches.
+ * When queue is full, backpressure policy is applied. Policy supports one of the 3 values:
+ * 1 - block, writer waits for free space;
+ * 2 - drop, record is dropped and counted;
+ * 3 - grow, record is stored in additional list, which is written after the queue.
+ * Use open to open file and close to close it.
+ */
+struct fileLogger
+{
+    protected:
+        ///Queue cell. Sequence tells whenever cell is free for writer or filled for reader.
+        struct cell
+        {
+            std::atomic<size_t> sequence{0};
+            std::string record;
+        };
+
+        fileStream<char> stream;
+
+        unsigned short privatePolicy = 1;
+
+        ///Error storage. Writers of several threads report into it.
+        std::atomic<int> privateError{0};
+
+        cell* cells = nullptr;
+
+        size_t mask = 0;
+
+        std::atomic<size_t> writePlace{0};
+
+        ///Used only by background thread.
+        size_t readPlace = 0;
+
+        //Grow policy storage. When list isn't empty, all records go into it to keep order of every writer.
+        std::mutex overflowGuard;
+        std::vector<std::string> overflow;
+        std::atomic<bool> overflowing{false};
+
+        //Background thread sleeping storage.
+        std::mutex sleepGuard;
+        std::condition_variable wake;
+        std::atomic<bool> sleeping{false};
+        std::atomic<bool> stopping{false};
+
+        //Blocked writers sleeping storage, it uses the same mutex.
+        std::condition_variable spaceFreed;
+        std::atomic<size_t> waitingWriters{0};
+
+        ///Amount of writers inside write, close waits for them before queue is freed.
+        std::atomic<size_t> activeWriters{0};
+
+        std::thread consumer;
+
+        std::atomic<std::uint64_t> enqueued{0};
+        std::atomic<std::uint64_t> dropped{0};
+        std::atomic<std::uint64_t> grown{0};
+        std::atomic<std::uint64_t> blocked{0};
+        std::atomic<std::uint64_t> batches{0};
+        std::atomic<std::uint64_t> totalEnqueueLatency{0};
+        std::atomic<std::uint64_t> maxEnqueueLatency{0};
+
+        ///Records are collected into batch until it has this size.
+        const static size_t batchSize = 1 << 20;
+
+        ///Amount of yields of blocked writer before it sleeps.
+        const static unsigned spinLimit = 64;
+
+    private:
+        ///Places record into queue. Returns false if queue is full.
+        bool tryEnqueue(std::string& record)
+        {
+            size_t place = writePlace.load(std::memory_order_relaxed);
+            while(true)
+            {
+                cell& current = cells[place & mask];
+                size_t sequence = current.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)place;
+                if(difference == 0)
+                {
+                    if(writePlace.compare_exchange_weak(place, place + 1, std::memory_order_relaxed))
+                    {
+                        current.record.swap(record);
+                        current.sequence.store(place + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if(difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    place = writePlace.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        ///Takes record from queue. Returns false if queue is empty.
+        bool tryDequeue(std::string& batch)
+        {
+            cell& current = cells[readPlace & mask];
+            if(current.sequence.load(std::memory_order_acquire) != readPlace + 1)
+            {
+                return false;
+            }
+            batch.append(current.record);
+            current.record.clear();
+            current.sequence.store(readPlace + mask + 1, std::memory_order_release);
+            ++readPlace;
+            return true;
+        }
+
+        void wakeConsumer()
+        {
+            if(sleeping.exchange(false))
+            {
+                std::lock_guard<std::mutex> lock(sleepGuard);
+                wake.notify_one();
+            }
+        }
+
+        void consumeLoop()
+        {
+            std::string batch;
+            while(true)
+            {
+                //Writer, which passed the stopping check, may still add record.
+                bool finishing = stopping.load() and activeWriters.load() == 0;
+                batch.clear();
+                while(batch.size() < batchSize and tryDequeue(batch));
+                if(!batch.empty() and waitingWriters.load() != 0)
+                {
+                    std::lock_guard<std::mutex> lock(sleepGuard);
+                    spaceFreed.notify_all();
+                }
+                if(batch.size() < batchSize and overflowing.load())
+                {
+                    std::lock_guard<std::mutex> lock(overflowGuard);
+                    //Dequeuing stops at reserved but not yet filled cell, and cells after it may hold older records of the same writer.
+                    //So list is taken only after every reserved cell was read, until then all records keep going into it.
+                    if(readPlace == writePlace.load(std::memory_order_acquire))
+                    {
+                        for(const std::string& record : overflow)
+                        {
+                            batch.append(record);
+                        }
+                        overflow.clear();
+                        overflowing.store(false);
+                    }
+                }
+                if(!batch.empty())
+                {
+                    stream.writeBlock(&batch[0], batch.size());
+                    stream.flush();
+                    ++batches;
+                    continue;
+                }
+                if(finishing)
+                {
+                    return;
+                }
+                std::unique_lock<std::mutex> lock(sleepGuard);
+                sleeping.store(true);
+                //Timeout covers writer, which filled queue right before sleeping flag was set.
+                wake.wait_for(lock, std::chrono::milliseconds(1));
+                sleeping.store(false);
+            }
+        }
+
+        void recordLatency(std::chrono::steady_clock::time_point started)
+        {
+            std::uint64_t latency = (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count();
+            totalEnqueueLatency += latency;
+            std::uint64_t longest = maxEnqueueLatency.load(std::memory_order_relaxed);
+            while(latency > longest and !maxEnqueueLatency.compare_exchange_weak(longest, latency, std::memory_order_relaxed));
+        }
+
+    public:
+        ///Last error storage. Uneditable from outside.
+        const std::atomic<int> &error = privateError;
+
+        ///Used backpressure policy. Uneditable from outside.
+        const unsigned short &policy = privatePolicy;
+
+        fileLogger() = default;
+
+        fileLogger(const fileLogger&) = delete;
+
+        /**Opens log file for appending.
+        *Capacity of queue is rounded up to power of two.
+        *Policy supports one of the 3 values: 1 - block; 2 - drop; 3 - grow.
+        */
+        void open(const char* choosenPath, size_t capacity = 4096, unsigned short backpressurePolicy = 1, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            if(stream.isStreamOpen() or capacity == 0 or backpressurePolicy < 1 or backpressurePolicy > 3)
+            {
+                privateError = errorCode;
+                return;
+            }
+            stream.open(choosenPath, 3, true, errorCode);
+            if(stream.error != 0)
+            {
+                privateError = stream.getError();
+                return;
+            }
+            size_t rounded = 1;
+            while(rounded < capacity)
+            {
+                rounded <<= 1;
+            }
+            cells = new cell[rounded];
+            for(size_t i = 0; i < rounded; ++i)
+            {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            mask = rounded - 1;
+            writePlace.store(0);
+            readPlace = 0;
+            privatePolicy = backpressurePolicy;
+            stopping.store(false);
+            consumer = std::thread(&fileLogger::consumeLoop, this);
+        }
+
+        /**Adds preformatted record. Returns false if record was dropped or logger isn't open.
+        *Safe to call from several threads, also while other thread closes logger.
+        */
+        bool write(const char* data, size_t size, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            std::string record(data, size);
+            return write(record, errorCode);
+        }
+
+        ///Adds record, taking its content. See write.
+        bool write(std::string& record, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            auto started = std::chrono::steady_clock::now();
+            ++activeWriters;
+            //Stopping is checked first, queue of closed logger may be freed.
+            if(stopping.load() or cells == nullptr)
+            {
+                privateError = errorCode;
+                --activeWriters;
+                return false;
+            }
+            unsigned spins = 0;
+            while(true)
+            {
+                if(overflowing.load())
+                {
+                    std::lock_guard<std::mutex> lock(overflowGuard);
+                    if(overflowing.load())
+                    {
+                        overflow.push_back(std::move(record));
+                        ++grown;
+                        break;
+                    }
+                }
+                if(tryEnqueue(record))
+                {
+                    break;
+                }
+                wakeConsumer();
+                if(privatePolicy == 2)
+                {
+                    ++dropped;
+                    --activeWriters;
+                    return false;
+                }
+                if(privatePolicy == 3)
+                {
+                    std::lock_guard<std::mutex> lock(overflowGuard);
+                    overflowing.store(true);
+                    overflow.push_back(std::move(record));
+                    ++grown;
+                    break;
+                }
+                if(spins == 0)
+                {
+                    ++blocked;
+                }
+                if(++spins <= spinLimit)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleepGuard);
+                ++waitingWriters;
+                //Timeout covers consumer, which freed space right before waiting writer was counted.
+                spaceFreed.wait_for(lock, std::chrono::milliseconds(1));
+                --waitingWriters;
+            }
+            ++enqueued;
+            recordLatency(started);
+            wakeConsumer();
+            --activeWriters;
+            return true;
+        }
+
+        ///Adds line, '\n' is added to its end. See write.
+        bool writeLine(const char* line, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            if(line == nullptr)
+            {
+                privateError = errorCode;
+                return false;
+            }
+            std::string record = line;
+            record.push_back('\n');
+            return write(record, errorCode);
+        }
+
+        ///Returns current counters.
+        fileLoggerStatistics statistics() const
+        {
+            fileLoggerStatistics current;
+            current.enqueued = enqueued.load();
+            current.dropped = dropped.load();
+            current.grown = grown.load();
+            current.blocked = blocked.load();
+            current.batches = batches.load();
+            current.totalEnqueueLatency = totalEnqueueLatency.load();
+            current.maxEnqueueLatency = maxEnqueueLatency.load();
+            return current;
+        }
+
+        ///Writes all added records and closes stream. Writes of other threads started meanwhile return false.
+        void close()
+        {
+            stopping.store(true);
+            if(consumer.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(sleepGuard);
+                    wake.notify_one();
+                }
+                consumer.join();
+            }
+            //Writers coming after consumer ended only see stopping flag, so they are waited for before queue is freed.
+            while(activeWriters.load() != 0)
+            {
+                std::this_thread::yield();
+            }
+            if(stream.error != 0)
+            {
+                privateError = stream.error;
+            }
+            stream.close();
+            delete[] cells;
+            cells = nullptr;
+        }
+
+        ///Close logger automatically during destruction.
+        ~fileLogger()
+        {
+            close();
+        }
+};
+
+/**
+ * Reader of binary file, which reads ahead in background.
+ * Background thread fills next buffers while current one is consumed, so reading from storage overlaps with processing.
+ * Offers the same readBlock and readVariable functions as file stream.
+ * Use open to open file and close to close it.
+ */
+struct filePrefetchReader
+{
+    protected:
+        ///Buffer filled by background thread.
+        struct buffer
+        {
+            std::vector<unsigned char> data;
+            size_t size = 0;
+            bool filled = false;
+        };
+
+        fileStream<char> stream;
+
+        std::vector<buffer> buffers;
+
+        ///Error storage.
+        int privateError = 0;
+
+        bool privateEndOfFile = false;
+
+        std::mutex guard;
+
+        std::condition_variable changed;
+
+        ///Buffer filled next by background thread.
+        size_t fillPlace = 0;
+
+        //Consumer storage.
+        size_t readBuffer = 0;
+        size_t readPlace = 0;
+
+        ///Background thread reached end of file or error.
+        bool sourceEnd = false;
+
+        int sourceError = 0;
+
+        bool stopping = false;
+
+        std::thread producer;
+
+    private:
+        void produceLoop()
+        {
+            std::unique_lock<std::mutex> lock(guard);
+            while(!stopping and !sourceEnd)
+            {
+                changed.wait(lock, [this]()
+                {
+                    return stopping or !buffers[fillPlace].filled;
+                });
+                if(stopping)
+                {
+                    return;
+                }
+                buffer& current = buffers[fillPlace];
+                lock.unlock();
+                size_t result = stream.readBlockInto(current.data.data(), current.data.size());
+                int streamError = stream.getError();
+                bool ended = stream.end or result < current.data.size();
+                lock.lock();
+                if(result > 0)
+                {
+                    current.size = result;
+                    current.filled = true;
+                    fillPlace = (fillPlace + 1) % buffers.size();
+                }
+                else if(streamError != 0)
+                {
+                    sourceError = streamError;
+                }
+                sourceEnd = ended or sourceError != 0;
+                changed.notify_all();
+            }
+        }
+
+        ///Copies choosen amount of bytes. Returns amount of copied bytes, which is smaller only at the end of file.
+        size_t copyBytes(unsigned char* destination, size_t count)
+        {
+            size_t done = 0;
+            std::unique_lock<std::mutex> lock(guard);
+            while(done < count)
+            {
+                buffer& current = buffers[readBuffer];
+                changed.wait(lock, [this, &current]()
+                {
+                    return current.filled or sourceEnd;
+                });
+                if(!current.filled)
+                {
+                    break;
+                }
+                lock.unlock();
+                size_t part = (current.size - readPlace < count - done)?(current.size - readPlace):(count - done);
+                std::memcpy(destination + done, current.data.data() + readPlace, part);
+                done += part;
+                readPlace += part;
+                lock.lock();
+                if(readPlace == current.size)
+                {
+                    //Give buffer back to background thread.
+                    current.filled = false;
+                    readPlace = 0;
+                    readBuffer = (readBuffer + 1) % buffers.size();
+                    changed.notify_all();
+                }
+            }
+            updateEndOfFile();
+            return done;
+        }
+
+        ///Requires locked guard. Consumed buffers are given back immediately, so current buffer is either empty or has data.
+        void updateEndOfFile()
+        {
+            privateEndOfFile = sourceEnd and !buffers[readBuffer].filled;
+            if(sourceError != 0 and privateEndOfFile)
+            {
+                privateError = sourceError;
+            }
+        }
+
+    public:
+        ///Last error storage. Uneditable from outside.
+        const int &error = privateError;
+
+        ///Checks whenever it is end of file.
+        const bool &end = privateEndOfFile;
+
+        filePrefetchReader() = default;
+
+        filePrefetchReader(const filePrefetchReader&) = delete;
+
+        /**Opens binary file for reading with choosen amount and size of buffers.
+        *Two buffers are enough to read one while other is consumed, more buffers smooth uneven storage speed.
+        */
+        void open(const char* choosenPath, size_t bufferCount = 2, size_t bufferSize = 1 << 20, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            if(stream.isStreamOpen() or bufferCount < 2 or bufferSize == 0)
+            {
+                privateError = errorCode;
+                return;
+            }
+            stream.open(choosenPath, 1, true, errorCode);
+            if(stream.error != 0)
+            {
+                privateError = stream.getError();
+                return;
+            }
+            buffers.assign(bufferCount, buffer());
+            for(buffer& current : buffers)
+            {
+                current.data.resize(bufferSize);
+            }
+            fillPlace = readBuffer = readPlace = 0;
+            sourceError = 0;
+            stopping = false;
+            sourceEnd = stream.end;
+            privateEndOfFile = stream.end;
+            producer = std::thread(&filePrefetchReader::produceLoop, this);
+        }
+
+        /**Function which reads in binary into existing array. Returns amount of read elements.
+        *Syntax is following:
+        *readerName.readBlockInto<type of read value>(pointer to array, number of elements);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>::type>
+        size_t readBlockInto(type* pointer, size_t count, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            if(buffers.empty() or privateEndOfFile or pointer == nullptr)
+            {
+                privateError = errorCode;
+                return 0;
+            }
+            return copyBytes(reinterpret_cast<unsigned char*>(pointer), sizeof(type) * count) / sizeof(type);
+        }
+
+        /**Function which reads in binary into new array, which is freed by delete[].
+        *Like file stream, it returns nullptr only if nothing could be read. Elements after end of file are zero.
+        *Syntax is following:
+        *readerName.readBlock<type of read value>(number of elements);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>::type>
+        type* readBlock(const size_t &count, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            if(count == 0)
+            {
+                privateError = ENOTSUP; //Same as file stream.
+                return nullptr;
+            }
+            type* pointer = new type[count]();
+            if(readBlockInto<type>(pointer, count, errorCode) == 0)
+            {
+                privateError = (privateError != 0)?(privateError):(errorCode);
+                delete[] pointer;
+                return nullptr;
+            }
+            return pointer;
+        }
+
+        /**Function which reads in binary.
+        *Syntax is following:
+        *readerName.readVariable<type of read value>();
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>::type>
+        type readVariable(int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            type variable{};
+            if(readBlockInto<type>(&variable, 1, errorCode) != 1)
+            {
+                privateError = (privateError != 0)?(privateError):(errorCode);
+                return {};
+            }
+            return variable;
+        }
+
+        ///Stops background thread and closes stream.
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                stopping = true;
+                changed.notify_all();
+            }
+            if(producer.joinable())
+            {
+                producer.join();
+            }
+            stream.close();
+            buffers.clear();
+            privateEndOfFile = false;
+        }
+
+        ///Close reader automatically during destruction.
+        ~filePrefetchReader()
+        {
+            close();
+        }
+};
+
+/**
+ * Settings of delimited text reader.
+ * Comma is used for CSV, tabulator for TSV.
+ */
+struct fileCsvSettings
+{
+    ///Character separating fields.
+    char delimiter = ',';
+
+    ///Character enclosing quoted fields, doubled inside of them. '\0' disables quoting.
+    char quote = '"';
+
+    ///Initial size of read buffer. It grows if single record doesn't fit into it.
+    size_t bufferSize = 1 << 20;
+};
+
+/**
+ * Reader of delimited text files like CSV or TSV, returning fields as string views without copying them.
+ * Text is read in large blocks and searched for delimiters and line ends 32 bytes at once with AVX2 or 16 bytes with SSE2, if compiler targets them, otherwise byte by byte.
+ * Records end with "\n", "\r\n" or "\r". Quoted fields can contain delimiters, line ends and doubled quotes.
+ * Malformed quoted fields stop reading with EILSEQ error instead of being guessed at.
+ * Use open to open file and close to close it.
+ */
+struct fileCsvReader
+{
+    protected:
+        ///Field found in buffer.
+        struct range
+        {
+            size_t start;
+            size_t end;
+            bool escaped;
+        };
+
+        fileStream<char> stream;
+
+        fileCsvSettings settings;
+
+        std::vector<char> buffer;
+
+        ///Start of unparsed data.
+        size_t begin = 0;
+
+        ///End of read data.
+        size_t filled = 0;
+
+        bool sourceEnd = false;
+
+        std::vector<range> ranges;
+
+        //Field by field reading storage.
+        std::vector<std::string_view> currentRecord;
+        size_t currentField = 0;
+
+        ///Error storage.
+        int privateError = 0;
+
+        std::uint64_t privateRecords = 0;
+
+    private:
+        ///Finds first delimiter or line end at or after choosen place. Returns end if there is none.
+        size_t findSpecial(size_t place, size_t end) const
+        {
+            const char* data = buffer.data();
+            #if defined(__AVX2__)
+            const __m256i delimiters = _mm256_set1_epi8(settings.delimiter), newLines = _mm256_set1_epi8('\n'), returns = _mm256_set1_epi8('\r');
+            for(; place + 32 <= end; place += 32)
+            {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + place));
+                __m256i found = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, delimiters), _mm256_cmpeq_epi8(block, newLines)), _mm256_cmpeq_epi8(block, returns));
+                unsigned mask = (unsigned)_mm256_movemask_epi8(found);
+                if(mask != 0)
+                {
+                    return place + (size_t)__builtin_ctz(mask);
+                }
+            }
+            #endif
+            #if defined(__SSE2__)
+            const __m128i delimiters16 = _mm_set1_epi8(settings.delimiter), newLines16 = _mm_set1_epi8('\n'), returns16 = _mm_set1_epi8('\r');
+            for(; place + 16 <= end; place += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + place));
+                __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, delimiters16), _mm_cmpeq_epi8(block, newLines16)), _mm_cmpeq_epi8(block, returns16));
+                unsigned mask = (unsigned)_mm_movemask_epi8(found);
+                if(mask != 0)
+                {
+                    return place + (size_t)__builtin_ctz(mask);
+                }
+            }
+            #endif
+            for(; place < end; ++place)
+            {
+                char current = data[place];
+                if(current == settings.delimiter or current == '\n' or current == '\r')
+                {
+                    return place;
+                }
+            }
+            return end;
+        }
+
+        /**Finds fields of record starting at begin. Returns false if record doesn't end in read data and more data can be read.
+        *Place after the record is written into next. Malformed quoted field sets error to EILSEQ.
+        */
+        bool parseRecord(size_t& next)
+        {
+            const char* data = buffer.data();
+            ranges.clear();
+            size_t place = begin;
+            while(true)
+            {
+                range field = {place, place, false};
+                bool quoted = false;
+                if(settings.quote != '\0' and place < filled and data[place] == settings.quote)
+                {
+                    //Quoted field ends with single quote, doubled ones are part of it.
+                    quoted = true;
+                    size_t search = place + 1;
+                    while(true)
+                    {
+                        const void* found = std::memchr(data + search, settings.quote, filled - search);
+                        if(found == nullptr)
+                        {
+                            if(!sourceEnd)
+                            {
+                                return false;
+                            }
+                            //Unterminated quote would take the rest of file.
+                            privateError = EILSEQ;
+                            return true;
+                        }
+                        size_t quotePlace = (size_t)(static_cast<const char*>(found) - data);
+                        if(quotePlace + 1 >= filled and !sourceEnd)
+                        {
+                            return false;
+                        }
+                        if(quotePlace + 1 < filled and data[quotePlace + 1] == settings.quote)
+                        {
+                            field.escaped = true;
+                            search = quotePlace + 2;
+                            continue;
+                        }
+                        field = {place + 1, quotePlace, field.escaped};
+                        place = quotePlace + 1;
+                        break;
+                    }
+                }
+                size_t special = findSpecial(place, filled);
+                if(!quoted)
+                {
+                    field.end = special;
+                }
+                else if(special != place)
+                {
+                    //Closing quote must be followed by delimiter or line end.
+                    privateError = EILSEQ;
+                    return true;
+                }
+                if(special == filled)
+                {
+                    if(!sourceEnd)
+                    {
+                        return false;
+                    }
+                    ranges.push_back(field);
+                    next = filled;
+                    return true;
+                }
+                ranges.push_back(field);
+                if(data[special] == settings.delimiter)
+                {
+                    place = special + 1;
+                    continue;
+                }
+                if(data[special] == '\r')
+                {
+                    if(special + 1 >= filled and !sourceEnd)
+                    {
+                        //Line end might continue with '\n' in data not read yet.
+                        return false;
+                    }
+                    next = (special + 1 < filled and data[special + 1] == '\n')?(special + 2):(special + 1);
+                    return true;
+                }
+                next = special + 1;
+                return true;
+            }
+        }
+
+        ///Moves unparsed data to the start of buffer, grows buffer if it is full and reads more data.
+        void refill()
+        {
+            if(begin > 0)
+            {
+                std::memmove(buffer.data(), buffer.data() + begin, filled - begin);
+                filled -= begin;
+                begin = 0;
+            }
+            if(filled == buffer.size())
+            {
+                //Single record is larger than buffer.
+                buffer.resize(buffer.size() * 2);
+            }
+            size_t result = stream.readBlockInto(buffer.data() + filled, buffer.size() - filled);
+            filled += result;
+            if(result == 0 or stream.end)
+            {
+                sourceEnd = true;
+                if(stream.error != 0)
+                {
+                    privateError = stream.getError();
+                }
+            }
+        }
+
+    public:
+        ///Last error storage. Uneditable from outside.
+        const int &error = privateError;
+
+        ///Amount of records read since opening. Uneditable from outside.
+        const std::uint64_t &records = privateRecords;
+
+        fileCsvReader() = default;
+
+        fileCsvReader(const fileCsvReader&) = delete;
+
+        /**Opens delimited text file with choosen settings.
+        *Syntax is following:
+        *readerName.open("file.csv", settings);
+        */
+        void open(const char* choosenPath, const fileCsvSettings& choosenSettings = fileCsvSettings(), int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            if(stream.isStreamOpen() or choosenSettings.bufferSize == 0 or choosenSettings.delimiter == '\n' or choosenSettings.delimiter == '\r' or choosenSettings.delimiter == choosenSettings.quote)
+            {
+                privateError = errorCode;
+                return;
+            }
+            privateError = 0;
+            //Binary mode reads blocks without conversion of line ends.
+            stream.open(choosenPath, 1, true, errorCode);
+            if(stream.error != 0)
+            {
+                privateError = stream.getError();
+                return;
+            }
+            settings = choosenSettings;
+            buffer.assign(settings.bufferSize, '\0');
+            begin = filled = 0;
+            sourceEnd = stream.end;
+            currentRecord.clear();
+            currentField = 0;
+            privateRecords = 0;
+        }
+
+        /**Reads next record. Returns false at the end of file or on error.
+        *Text after closing quote other than delimiter or line end and quote without closing one set error to EILSEQ.
+        *Fields stay valid until next reading. Quoted fields are returned without quotes and with doubled quotes made single.
+        *Syntax is following:
+        *while(readerName.nextRecord(fields))
+        */
+        bool nextRecord(std::vector<std::string_view>& fields)
+        {
+            fields.clear();
+            if(!stream.isStreamOpen() or privateError != 0)
+            {
+                return false;
+            }
+            size_t next = 0;
+            while(!parseRecord(next))
+            {
+                refill();
+                if(privateError != 0)
+                {
+                    return false;
+                }
+            }
+            if(privateError != 0 or begin == filled)
+            {
+                return false;
+            }
+            char* data = buffer.data();
+            for(const range& field : ranges)
+            {
+                size_t end = field.end;
+                if(field.escaped)
+                {
+                    //Removing doubled quotes only shortens field, so it is done in place.
+                    end = field.start;
+                    for(size_t place = field.start; place < field.end; ++place)
+                    {
+                        data[end++] = data[place];
+                        place += (data[place] == settings.quote)?(1):(0);
+                    }
+                }
+                fields.emplace_back(data + field.start, end - field.start);
+            }
+            begin = next;
+            ++privateRecords;
+            return true;
+        }
+
+        /**Reads next field. Returns false at the end of file or on error.
+        *Last field of every record sets endOfRecord to true.
+        *Syntax is following:
+        *while(readerName.nextField(field, endOfRecord))
+        */
+        bool nextField(std::string_view& field, bool& endOfRecord)
+        {
+            if(currentField >= currentRecord.size())
+            {
+                currentField = 0;
+                if(!nextRecord(currentRecord))
+                {
+                    return false;
+                }
+            }
+            field = currentRecord[currentField++];
+            endOfRecord = currentField == currentRecord.size();
+            return true;
+        }
+
+        ///Closes reader.
+        void close()
+        {
+            stream.close();
+            buffer.clear();
+            ranges.clear();
+            currentRecord.clear();
+            begin = filled = currentField = 0;
+            sourceEnd = false;
+        }
+
+        ///Close reader automatically during destruction.
+        ~fileCsvReader()
+        {
+            close();
+        }
+};
+
+/**
+ * File stream with opening mode and binary mode chosen at compile time.
+ * Functions not allowed by the modes fail to compile, so per-call checks of modes, clearing of error indicators and size seeks after every call aren't needed.
+ * End of file is found from short reads, errors from C stream error indicator. Like file stream, it must be used by one thread at a time, so unlocked C stream functions are used where available.
+ * Opening mode and binary mode have the same meaning as in file stream.
+ * Syntax is following:
+ * fileStaticStream<2, true> fileStreamName("file.bin");
+ */
+template<unsigned short openingMode, bool binaryMode, class path_type = char>
+struct fileStaticStream : protected fileStream<path_type>
+{
+    static_assert(openingMode >= 1 and openingMode <= 6, "Opening mode supports values from 1 to 6.");
+
+    protected:
+        using base = fileStream<path_type>;
+
+        const static bool readable = openingMode == 1 or openingMode >= 4;
+
+        const static bool writable = openingMode >= 2;
+
+        const static bool seekable = openingMode != 3;
+
+        ///Last direction of raw access, 0 - unknown, 1 - reading, 2 - writing.
+        unsigned short lastDirection = 0;
+
+        ///C stream requires positioning between reading and writing, so it is done when direction of raw access changes.
+        void switchDirection(unsigned short direction, FILE* file)
+        {
+            if(readable and writable and lastDirection != direction)
+            {
+                fseek(file, 0, SEEK_CUR);
+            }
+            lastDirection = direction;
+        }
+
+        size_t readRaw(void* data, size_t size, size_t count, FILE* file)
+        {
+            switchDirection(1, file);
+            #if defined(__GLIBC__) && defined(_GNU_SOURCE)
+            return fread_unlocked(data, size, count, file);
+            #else
+            return fread(data, size, count, file);
+            #endif
+        }
+
+        size_t writeRaw(const void* data, size_t size, size_t count, FILE* file)
+        {
+            switchDirection(2, file);
+            #if defined(__GLIBC__) && defined(_GNU_SOURCE)
+            return fwrite_unlocked(data, size, count, file);
+            #else
+            return fwrite(data, size, count, file);
+            #endif
+        }
+
+        ///Reports failed reading, which is either end of file or error.
+        void readFailed(size_t errorCode)
+        {
+            if(ferror(this->file) != 0)
+            {
+                this->privateError = (errno != 0)?(errno):((int)errorCode);
+                clearerr(this->file);
+                return;
+            }
+            this->privateEndOfFile = true;
+            this->privateError = (int)errorCode;
+        }
+
+        ///Reports failed writing.
+        void writeFailed(size_t errorCode)
+        {
+            this->privateError = (errno != 0)?(errno):((int)errorCode);
+            clearerr(this->file);
+        }
+
+    public:
+        using base::defaultErrorCode;
+        using base::error;
+        using base::path;
+        using base::end;
+        using base::isStreamOpen;
+        using base::cleanError;
+        using base::getError;
+        using base::close;
+        using base::release;
+
+        fileStaticStream() = default;
+
+        fileStaticStream(const fileStaticStream&) = delete;
+
+        ///Opens stream with modes of the type.
+        void open(const path_type* const& choosenPath, int errorCode = defaultErrorCode)
+        {
+            lastDirection = 0;
+            base::open(choosenPath, openingMode, binaryMode, errorCode);
+        }
+
+        ///Opens stream with modes of the type.
+        explicit fileStaticStream(const path_type* const& choosenPath, int errorCode = defaultErrorCode)
+        {
+            open(choosenPath, errorCode);
+        }
+
+        ///Placement in file.
+        size_t point(int errorCode = defaultErrorCode)
+        {
+            static_assert(seekable, "Append only stream has no placement.");
+            return base::point(errorCode);
+        }
+
+        ///Moves pointer to choosen place. See file stream pointTo for details.
+        void pointTo(int pointer, unsigned short from = 1, int errorCode = defaultErrorCode)
+        {
+            static_assert(seekable, "Append only stream can't be moved.");
+            lastDirection = 0;
+            base::pointTo(pointer, from, errorCode);
+        }
+
+        ///Resets file to zero position.
+        void reset(int errorCode = defaultErrorCode)
+        {
+            static_assert(seekable, "Append only stream can't be moved.");
+            lastDirection = 0;
+            base::reset(errorCode);
+        }
+
+        ///Returns size of a file.
+        size_t size(int errorCode = defaultErrorCode)
+        {
+            static_assert(seekable, "Append only stream can't report its size.");
+            lastDirection = 0;
+            return base::size(errorCode);
+        }
+
+        ///Writes buffered data into file.
+        void flush(int errorCode = defaultErrorCode)
+        {
+            static_assert(writable, "Stream isn't opened for writing.");
+            lastDirection = 0;
+            base::flush(errorCode);
+        }
+
+        ///Writes buffered data and synchronizes file with storage. See file stream sync for details.
+        void sync(unsigned short synchronization = 2, int errorCode = defaultErrorCode)
+        {
+            static_assert(writable, "Stream isn't opened for writing.");
+            lastDirection = 0;
+            base::sync(synchronization, errorCode);
+        }
+
+        ///Reads character. See file stream getCharacter for details.
+        template<class char_type = char>
+        char_type getCharacter(int errorCode = defaultErrorCode)
+        {
+            static_assert(readable, "Stream isn't opened for reading.");
+            lastDirection = 0;
+            return base::template getCharacter<char_type>(errorCode);
+        }
+
+        ///Reads line. See file stream getLine for details.
+        template<class char_type = char>
+        char_type* getLine(int errorCode = defaultErrorCode)
+        {
+            static_assert(readable, "Stream isn't opened for reading.");
+            lastDirection = 0;
+            return base::template getLine<char_type>(errorCode);
+        }
+
+        ///Reads whole file. See file stream getFile for details.
+        template<class char_type = char>
+        char_type* getFile(int errorCode = defaultErrorCode)
+        {
+            static_assert(readable, "Stream isn't opened for reading.");
+            lastDirection = 0;
+            return base::template getFile<char_type>(errorCode);
+        }
+
+        ///Writes character. See file stream writeCharacter for details.
+        template<class char_type = char>
+        void writeCharacter(const char_type character, int errorCode = defaultErrorCode)
+        {
+            static_assert(writable, "Stream isn't opened for writing.");
+            lastDirection = 0;
+            base::template writeCharacter<char_type>(character, errorCode);
+        }
+
+        ///Writes string. See file stream writeString for details.
+        template<class char_type = char>
+        void writeString(const char_type* const& string, size_t expectedSize = 0, int errorCode = defaultErrorCode)
+        {
+            static_assert(writable, "Stream isn't opened for writing.");
+            lastDirection = 0;
+            base::template writeString<char_type>(string, expectedSize, errorCode);
+        }
+
+        ///Writes line. See file stream writeLine for details.
+        template<class char_type = char>
+        void writeLine(const char_type* const& string, size_t expectedSize = 0, int errorCode = defaultErrorCode)
+        {
+            static_assert(writable, "Stream isn't opened for writing.");
+            lastDirection = 0;
+            base::template writeLine<char_type>(string, expectedSize, errorCode);
+        }
+
+        /**Function which reads in binary. Enforces for the type to be trivially copyable.
+        *Syntax is following:
+        *fileStreamName.readVariable<type of read value>();
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        type readVariable(size_t errorCode = defaultErrorCode)
         {
-            if(!isStreamOpen())
+            static_assert(readable, "Stream isn't opened for reading.");
+            static_assert(binaryMode, "Binary reading requires binary mode.");
+            if(this->file == nullptr)
             {
-                privateError = errorCode;
-                return;
+                this->privateError = (int)errorCode;
+                return {};
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            switch(openingMode)
+            type variable;
+            if(readRaw(&variable, sizeof(type), 1, this->file) != 1)
             {
-                default: privateError = errorCode; return;
-                case 1: file = freopen(privatePath, (binaryMode)?("rb"):("r"), file); break;
-                case 2: file = freopen(privatePath, (binaryMode)?("wb"):("w"), file); break;
-                case 3: file = freopen(privatePath, (binaryMode)?("ab"):("a"), file); break;
-                case 4: file = freopen(privatePath, (binaryMode)?("rb+"):("r+"), file); break;
-                case 5: file = freopen(privatePath, (binaryMode)?("wb+"):("w+"), file); break;
-                case 6: file = freopen(privatePath, (binaryMode)?("ab+"):("a+"), file); break;
+                readFailed(errorCode);
+                return {};
             }
-            if(file == nullptr or isError())
+            return variable;
+        }
+
+        /**Function which reads in binary into existing array. Enforces for the type to be trivially copyable.
+        *Returns amount of read elements, which is smaller than requested at the end of file.
+        *Syntax is following:
+        *fileStreamName.readBlockInto<type of read value>(pointer to array, number of elements);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        size_t readBlockInto(type* pointer, size_t count, size_t errorCode = defaultErrorCode)
+        {
+            static_assert(readable, "Stream isn't opened for reading.");
+            static_assert(binaryMode, "Binary reading requires binary mode.");
+            if(this->file == nullptr)
             {
-                privateError = extractError();
+                this->privateError = (int)errorCode;
+                return 0;
+            }
+            size_t result = readRaw(pointer, sizeof(type), count, this->file);
+            if(result != count)
+            {
+                //Short read at the end of file isn't error here, only error indicator is.
+                int savedError = this->privateError;
+                readFailed(errorCode);
+                this->privateError = (this->privateEndOfFile)?(savedError):(this->privateError);
+            }
+            return result;
+        }
+
+        /**Function which reads in binary into new array. See file stream readBlock for details.
+        *Syntax is following:
+        *fileStreamName.readBlock<type of read value>(number of elements);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        type* readBlock(const size_t &count, size_t errorCode = defaultErrorCode)
+        {
+            static_assert(readable, "Stream isn't opened for reading.");
+            static_assert(binaryMode, "Binary reading requires binary mode.");
+            lastDirection = 0;
+            return base::template readBlock<type>(count, errorCode);
+        }
+
+        /**Function which writes in binary. Enforces for the type to be trivially copyable.
+        *Syntax is following:
+        *fileStreamName.writeVariable<type of written value, unnecessary>(written element);
+        */
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        void writeVariable(const type &variable, size_t errorCode = defaultErrorCode)
+        {
+            static_assert(writable, "Stream isn't opened for writing.");
+            static_assert(binaryMode, "Binary writing requires binary mode.");
+            if(this->file == nullptr)
+            {
+                this->privateError = (int)errorCode;
                 return;
             }
-            privateBinaryMode = binaryMode;
-            privateMode = openingMode;
-            privateEndOfFile = false;
-            updateEndOfFile();
+            if(writeRaw(&variable, sizeof(type), 1, this->file) != 1)
+            {
+                writeFailed(errorCode);
+            }
         }
 
-        /**Function to read character, which supports binary mode.
-        *You can specify type for read characters(char, char16_t, char32_t) as following:
-        *fileStreamName.getCharacter<type>();
+        /**Function which writes in binary. Enforces for the type to be trivially copyable.
+        *Syntax is following:
+        *fileStreamName.writeBlock<type of written value, unnecessary>(pointer to written element, number of elements);
         */
-        template<class char_type = char>
-        char_type getCharacter(int errorCode = defaultErrorCode)
+        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
+        void writeBlock(type* pointer, size_t count, size_t errorCode = defaultErrorCode)
         {
-            if(!isValidForReading())
+            static_assert(writable, "Stream isn't opened for writing.");
+            static_assert(binaryMode, "Binary writing requires binary mode.");
+            if(this->file == nullptr)
             {
-                privateError = errorCode;
-                return '\0';
+                this->privateError = (int)errorCode;
+                return;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            if(privateBinaryMode)
+            if(writeRaw(pointer, sizeof(type), count, this->file) != count)
             {
-                char_type data = readVariable<char_type>();
-                privateError = extractError();
-                if(isError())
-                {
-                    privateError = extractError();
-                    clearErrorPointing();
-                    return '\0';
-                }
-                updateEndOfFile();
-                return data;
+                writeFailed(errorCode);
             }
-            else
+        }
+};
+
+#ifdef LIBFILESTREAM_POSIX
+/**
+ * Settings of stream pool.
+ * Validation supports one of the 2 values:
+ * 0 - cached stream is given without checking the file;
+ * 1 - file is checked with stat, stream is reopened if file was replaced or changed since stream was returned.
+ */
+struct fileStreamPoolSettings
+{
+    ///Maximal amount of open streams kept in pool.
+    size_t capacity = 1024;
+
+    unsigned short validation = 1;
+};
+
+/**
+ * Counters of stream pool.
+ */
+struct fileStreamPoolStatistics
+{
+    ///Amount of checkouts given cached stream.
+    std::uint64_t hits = 0;
+
+    ///Amount of checkouts, which opened file.
+    std::uint64_t misses = 0;
+
+    ///Amount of cached streams closed because file was replaced or changed.
+    std::uint64_t invalidations = 0;
+
+    ///Amount of cached streams closed because pool was full.
+    std::uint64_t evictions = 0;
+
+    ///Part of checkouts given cached stream, 0 if there were none.
+    double hitRate() const
+    {
+        return (hits + misses == 0)?(0.0):((double)hits / (double)(hits + misses));
+    }
+};
+
+/**
+ * Pool of open file streams, keyed by path, opening mode and binary mode.
+ * Checked out stream is given by value and taken back by move, so it is used exactly as stream opened by open.
+ * Returned streams are kept open, least recently used ones are closed when pool is full.
+ * Cached stream is given rewound to the beginning, streams of modes 2 and 5 are also truncated, as opening would do.
+ * Pool is safe to use from several threads.
+ * Syntax is following:
+ * fileStream<char> fileStreamName = poolName.checkout(path, 1);
+ * poolName.giveBack(std::move(fileStreamName));
+ */
+struct fileStreamPool
+{
+    protected:
+        ///Cached stream with state of its file at the moment it was returned.
+        struct entry
+        {
+            std::string key;
+            fileStream<char> stream;
+            dev_t device = 0;
+            ino_t inode = 0;
+            off_t size = 0;
+            std::int64_t modified = 0;
+
+            entry(std::string&& choosenKey, fileStream<char>&& returned) : key(std::move(choosenKey)), stream(std::move(returned)) {}
+        };
+
+        fileStreamPoolSettings privateSettings;
+
+        ///Error storage.
+        int privateError = 0;
+
+        std::mutex guard;
+
+        ///Most recently returned streams are at the front.
+        std::list<entry> recent;
+
+        std::unordered_multimap<std::string, std::list<entry>::iterator> cached;
+
+        fileStreamPoolStatistics privateStatistics;
+
+    private:
+        static std::string makeKey(const char* path, unsigned short openingMode, bool binaryMode)
+        {
+            std::string key = path;
+            key.push_back('\0');
+            key.push_back((char)('0' + openingMode));
+            key.push_back((binaryMode)?('b'):('t'));
+            return key;
+        }
+
+        ///Modification time in nanoseconds.
+        static std::int64_t modificationTime(const struct stat& status)
+        {
+            #if defined(__APPLE__)
+            return (std::int64_t)status.st_mtimespec.tv_sec * 1000000000 + status.st_mtimespec.tv_nsec;
+            #else
+            return (std::int64_t)status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+            #endif
+        }
+
+        ///Removes entry from map of keys, entry stays in list.
+        void forget(std::list<entry>::iterator place)
+        {
+            auto range = cached.equal_range(place->key);
+            for(auto current = range.first; current != range.second; ++current)
             {
-                char_type character = fgetc(file);
-                if(isError())
+                if(current->second == place)
                 {
-                    privateError = extractError();
-                    clearErrorPointing();
-                    return '\0';
+                    cached.erase(current);
+                    return;
                 }
-                updateEndOfFile();
-                return character;
             }
         }
 
-        /**Reads specific amount of text. Places '\0' in the end of the string.
-        *You can specify type for read characters(char, char16_t, char32_t) as following:
-        *fileStreamName.getString<type>();
-        */
-        template<class char_type = char>
-        char_type* getString(size_t neededSize, int errorCode = defaultErrorCode)
+        ///Removes entry from both containers. Its stream is closed.
+        void erase(std::list<entry>::iterator place)
         {
-            if(!isValidForReading())
+            forget(place);
+            recent.erase(place);
+        }
+
+        ///Checks whenever file of path is still the one, which stream has open, and wasn't changed since stream was returned.
+        bool isUnchanged(const char* path, const entry& cachedEntry) const
+        {
+            struct stat status;
+            if(stat(path, &status) != 0)
             {
-                privateError = errorCode;
-                return "";
+                return false;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            char_type* line = nullptr;
-            size_t stringSize = 0;
-            for(size_t i = 0; i < neededSize and !privateEndOfFile; ++i)
+            return status.st_dev == cachedEntry.device and status.st_ino == cachedEntry.inode and status.st_size == cachedEntry.size and modificationTime(status) == cachedEntry.modified;
+        }
+
+    public:
+        ///Last error storage. Uneditable from outside.
+        const int &error = privateError;
+
+        fileStreamPool() = default;
+
+        fileStreamPool(const fileStreamPoolSettings& settings) : privateSettings(settings) {}
+
+        fileStreamPool(const fileStreamPool&) = delete;
+
+        /**Gives stream of choosen file, opened with choosen parameters. Stream is taken from pool if possible, otherwise file is opened.
+        *Errors of opening are reported by returned stream.
+        *Syntax is following:
+        *fileStream<char> fileStreamName = poolName.checkout(path, openingMode, binaryMode);
+        */
+        fileStream<char> checkout(const char* choosenPath, unsigned short openingMode, bool binaryMode = false, int errorCode = fileStream<char>::defaultErrorCode)
+        {
+            std::list<entry> taken;
+            if(choosenPath != nullptr)
             {
-                char_type checkedCharacter = getCharacter<char_type>();
-                if(checkedCharacter == '\0')
+                std::string key = makeKey(choosenPath, openingMode, binaryMode);
+                std::lock_guard<std::mutex> lock(guard);
+                for(auto found = cached.find(key); found != cached.end(); found = cached.find(key))
                 {
-                    //privateError = errorCode; //Error already tracked.
-                    delete[] line;
-                    return "";
+                    std::list<entry>::iterator place = found->second;
+                    if(privateSettings.validation == 1 and !isUnchanged(choosenPath, *place))
+                    {
+                        ++privateStatistics.invalidations;
+                        erase(place);
+                        continue;
+                    }
+                    forget(place);
+                    taken.splice(taken.begin(), recent, place);
+                    break;
                 }
-                addToList(line, stringSize, checkedCharacter);
-                ++stringSize;
+                ++((taken.empty())?(privateStatistics.misses):(privateStatistics.hits));
+            }
+            if(taken.empty())
+            {
+                fileStream<char> opened;
+                opened.open(choosenPath, openingMode, binaryMode, errorCode);
+                return opened;
+            }
+            fileStream<char> given(std::move(taken.front().stream));
+            if(openingMode == 2 or openingMode == 5)
+            {
+                given.resize(0, errorCode);
+            }
+            if(openingMode != 3)
+            {
+                given.reset(errorCode);
             }
-            addToList(line, stringSize, '\0');
-            return line;
+            return given;
         }
 
-        /**Gets line of file. Assumes, that pointer placed at the start of the line. Replaces '\n' in the end with '\0'.
-        *You can specify type for read characters(char, char16_t, char32_t) as following:
-        *fileStreamName.getLine<type>();
+        /**Takes stream back into pool. Streams, which aren't open, have error, are kept in memory, or use compression, mapping, atomic writing, checksum or encoding, are closed instead.
+        *Syntax is following:
+        *poolName.giveBack(std::move(fileStreamName));
         */
-        template<class char_type = char>
-        char_type* getLine(int errorCode = defaultErrorCode)
+        void giveBack(fileStream<char>&& returned)
         {
-            if(!isValidForReading())
+            if(!returned.isStreamOpen() or returned.error != 0 or returned.privatePath == nullptr or returned.privateCompression != nullptr or returned.privateMapping != nullptr or returned.privateAtomic != nullptr or returned.privateChecksum != nullptr or returned.privateEncoding != nullptr or returned.privateMemory != nullptr)
             {
-                privateError = errorCode;
-                return "";
+                returned.close();
+                return;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            char_type* line = nullptr;
-            size_t stringSize = 0;
-            while(true)
+            if(returned.isValidForWriting())
             {
-                char_type checkedCharacter = getCharacter<char_type>();
-                if(checkedCharacter == '\0')
-                {
-                    //privateError = errorCode; //Error already tracked.
-                    delete[] line;
-                    return "";
-                }
-                if(checkedCharacter == '\n')
-                {
-                    addToList(line, stringSize, '\0');
-                    //++stringSize; //Variable 'stringSize' is assigned a value that is never used. CppCheck
-                    break;
-                }
-                addToList(line, stringSize, checkedCharacter);
-                ++stringSize;
+                returned.flush();
+            }
+            struct stat status;
+            if(returned.error != 0 or fstat(fileno(returned.file), &status) != 0)
+            {
+                returned.close();
+                return;
+            }
+            std::string key = makeKey(returned.privatePath, returned.privateMode, returned.privateBinaryMode);
+            std::lock_guard<std::mutex> lock(guard);
+            if(privateSettings.capacity == 0)
+            {
+                returned.close();
+                return;
+            }
+            recent.emplace_front(std::move(key), std::move(returned));
+            entry& added = recent.front();
+            added.device = status.st_dev;
+            added.inode = status.st_ino;
+            added.size = status.st_size;
+            added.modified = modificationTime(status);
+            cached.emplace(added.key, recent.begin());
+            while(recent.size() > privateSettings.capacity)
+            {
+                ++privateStatistics.evictions;
+                erase(std::prev(recent.end()));
             }
-            return line;
         }
 
-        /**Gets all content of the file.
-        *You can specify type for read characters(char, char16_t, char32_t) as following:
-        *fileStreamName.getFile<type>();
-        */
-        template<class char_type = char>
-        char_type* getFile(int errorCode = defaultErrorCode)
+        ///Closes cached streams of choosen file, for example after it was changed in a way stat doesn't notice.
+        void invalidate(const char* choosenPath, int errorCode = fileStream<char>::defaultErrorCode)
         {
-            if(!isValidForReading())
+            if(choosenPath == nullptr)
             {
                 privateError = errorCode;
-                return "";
+                return;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            char_type* line = nullptr;
-            size_t stringSize = 0;
-            while(!privateEndOfFile)
+            std::lock_guard<std::mutex> lock(guard);
+            for(auto place = recent.begin(); place != recent.end();)
+            {
+                auto next = std::next(place);
+                if(place->stream.privatePath != nullptr and std::strcmp(place->stream.privatePath, choosenPath) == 0)
+                {
+                    ++privateStatistics.invalidations;
+                    erase(place);
+                }
+                place = next;
+            }
+        }
+
+        ///Returns amount of cached streams.
+        size_t size()
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            return recent.size();
+        }
+
+        ///Returns current counters.
+        fileStreamPoolStatistics statistics()
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            return privateStatistics;
+        }
+
+        ///Closes all cached streams.
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            cached.clear();
+            recent.clear();
+        }
+
+        ///Close cached streams automatically during destruction.
+        ~fileStreamPool()
+        {
+            clear();
+        }
+};
+#endif
+
+#ifdef LIBFILESTREAM_POSIX
+/**
+ * Settings of file follower.
+ */
+struct fileFollowSettings
+{
+    ///Milliseconds between checks of file when no notification comes. It is the only way of waiting where inotify is unavailable.
+    int pollInterval = 1000;
+
+    ///Size of single read from file.
+    size_t bufferSize = 1 << 16;
+
+    ///Starts following from the end of file instead of its beginning, as tail -f does.
+    bool fromEnd = false;
+};
+
+/**
+ * Reader of text file, which another process keeps appending to.
+ * After reaching the end of file it sleeps until file grows, woken by inotify on Linux, or by timer elsewhere.
+ * Only complete lines are given. Truncated file is read again from its beginning.
+ * Rotated file, renamed and replaced by new one under the same path, is read to its end before new file is opened.
+ * Use open to open file and close to close it.
+ */
+struct fileFollower
+{
+    protected:
+        fileStream<char> stream;
+
+        std::string privatePath;
+
+        fileFollowSettings privateSettings;
+
+        ///Error storage.
+        int privateError = 0;
+
+        ///Read data, which wasn't given yet. Given lines are in front of pendingPlace.
+        std::string pending;
+
+        size_t pendingPlace = 0;
+
+        ///Amount of bytes read from current file.
+        std::uint64_t offset = 0;
+
+        ///Inotify descriptor and its watches, -1 if not used.
+        int notification = -1;
+
+        int fileWatch = -1;
+
+        int directoryWatch = -1;
+
+        ///Pipe waking waiting thread when following is stopped.
+        int wakeUp[2] = {-1, -1};
+
+        std::atomic<bool> stopping{false};
+
+        std::uint64_t privateRotations = 0;
+
+        std::uint64_t privateTruncations = 0;
+
+    private:
+        ///Takes next complete line out of pending data.
+        bool takeLine(std::string& line)
+        {
+            size_t found = pending.find('\n', pendingPlace);
+            if(found == std::string::npos)
             {
-                char_type checkedCharacter = getCharacter<char_type>();
-                if(checkedCharacter == '\0')
+                //Given part is dropped once it is bigger than the rest, so data is moved rarely.
+                if(pendingPlace > pending.size() / 2)
                 {
-                    //privateError = errorCode; //Error already tracked.
-                    delete[] line;
-                    return "";
+                    pending.erase(0, pendingPlace);
+                    pendingPlace = 0;
                 }
-                addToList(line, stringSize, checkedCharacter);
-                ++stringSize;
+                return false;
             }
-            addToList(line, stringSize, '\0');
-            return line;
+            line.assign(pending, pendingPlace, found - pendingPlace);
+            pendingPlace = found + 1;
+            return true;
         }
 
-        /**Function to write character, which supports binary mode.
-        *You can specify type for written characters(char, char16_t, char32_t).
-        *The syntax is following:
-        *fileStreamName.writeCharacter<type>(character to add);
+        /**Reads at most one buffer of data appended since last reading, so lines of big file are given out while it is read.
+        *Returns amount of read bytes, 0 at the end of file, -1 on failure.
         */
-        template<class char_type = char>
-        void writeCharacter(const char_type character, int errorCode = defaultErrorCode)
+        long long readAppended()
         {
-            if(!isValidForWriting())
-            {
-                privateError = errorCode;
-                return;
-            }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            if(privateBinaryMode)
+            int descriptor = fileno(stream.file);
+            while(true)
             {
-                writeVariable(character);
-                if(isError())
+                size_t used = pending.size();
+                pending.resize(used + privateSettings.bufferSize);
+                //Position is given explicitly, so position of C stream doesn't matter.
+                ssize_t result = pread(descriptor, &pending[used], privateSettings.bufferSize, (off_t)offset);
+                pending.resize(used + ((result > 0)?(result):(0)));
+                if(result < 0 and errno == EINTR)
                 {
-                    privateError = extractError();
-                    clearErrorPointing();
-                    return;
+                    continue;
                 }
-            }
-            else
-            {
-                fputc(character, file);
-                if(isError())
+                if(result > 0)
                 {
-                    privateError = extractError();
-                    clearErrorPointing();
-                    return;
+                    offset += result;
                 }
+                return (long long)result;
             }
-            updateEndOfFile(); //Only character function needs that.
         }
 
-        /**Function to write string to file, which supports binary mode.
-        *You can specify type for written characters(char, char16_t, char32_t).
-        *The syntax is following:
-        *fileStreamName.writeString<type>(string to add, expected size(unnecessary));
-        */
-        template<class char_type = char>
-        void writeString(const char_type* const& string, size_t expectedSize = 0, int errorCode = defaultErrorCode)
+        ///Adds inotify watch of currently open file.
+        void watchFile()
         {
-            if(!isValidForWriting() or (expectedSize != 0 and !isStringZeroTerminated(string, expectedSize)))
+            #if defined(__linux__)
+            if(notification == -1)
             {
-                privateError = errorCode;
                 return;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            int savedError = privateError;
-            size_t stringPlace = 0;
-            while(string[stringPlace] != '\0')
+            if(fileWatch != -1)
             {
-                writeCharacter<char_type>(string[stringPlace]);
-                if(privateError != savedError)
-                {
-                    return;
-                }
-                ++stringPlace;
+                inotify_rm_watch(notification, fileWatch);
             }
+            fileWatch = inotify_add_watch(notification, privatePath.c_str(), IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF);
+            #endif
         }
 
-        /**Function to write line, which supports binary mode.
-        *After writing line, goes to next line.
-        *You can specify type for written characters(char, char16_t, char32_t).
-        *The syntax is following:
-        *fileStreamName.writeLine<type>(string to add, expected size(unnecessary));
-        */
-        template<class char_type = char>
-        void writeLine(const char_type* const& string, size_t expectedSize = 0, int errorCode = defaultErrorCode)
+        ///Starts inotify, watching directory of file for replacement of file.
+        void startNotification()
         {
-            if(!isValidForWriting() or (expectedSize != 0 and !isStringZeroTerminated(string, expectedSize)))
+            #if defined(__linux__)
+            notification = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if(notification == -1)
             {
-                privateError = errorCode;
-                return;
+                return; //Timer is used instead.
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            int savedError = privateError;
-            size_t stringPlace = 0;
-            while(string[stringPlace] != '\0')
+            std::string directory = std::filesystem::path(privatePath).parent_path().string();
+            directoryWatch = inotify_add_watch(notification, (directory.empty())?("."):(directory.c_str()), IN_CREATE | IN_MOVED_TO);
+            watchFile();
+            #endif
+        }
+
+        ///Checks whenever path names other file than followed one, because followed one was renamed or removed and replaced.
+        bool isRotated()
+        {
+            struct stat current, named;
+            if(fstat(fileno(stream.file), &current) != 0 or stat(privatePath.c_str(), &named) != 0)
             {
-                writeCharacter<char_type>(string[stringPlace]);
-                if(privateError != savedError)
-                {
-                    return;
-                }
-                ++stringPlace;
+                return false;
             }
-            writeCharacter('\n');
-            if(privateError != savedError)
+            return current.st_dev != named.st_dev or current.st_ino != named.st_ino;
+        }
+
+        ///Returns true and starts reading from the beginning if file became shorter than read part.
+        bool isTruncated()
+        {
+            struct stat current;
+            if(fstat(fileno(stream.file), &current) != 0 or (std::uint64_t)current.st_size >= offset)
             {
-                return;
+                return false;
             }
+            offset = 0;
+            pending.clear();
+            pendingPlace = 0;
+            ++privateTruncations;
+            return true;
         }
 
-        /**Function, which resets file to zero position.
-        *Syntax is following:
-        *fileStreamName.reset()
-        */
-        void reset(int errorCode = defaultErrorCode)
+        ///Sleeps until file may have changed, following is stopped, or choosen amount of milliseconds passes.
+        void wait(int timeout)
         {
-            if(privateMode == 3 or !isStreamOpen())
+            pollfd descriptors[2] = {{wakeUp[0], POLLIN, 0}, {notification, POLLIN, 0}};
+            int interval = privateSettings.pollInterval;
+            if(timeout >= 0 and (interval < 0 or timeout < interval))
             {
-                privateError = errorCode;
-                return;
+                interval = timeout;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            privateEndOfFile = false;
-            rewind(file);
-            if(isError())
+            if(poll(descriptors, (notification == -1)?(1):(2), interval) <= 0)
             {
-                privateError = extractError();
-                clearErrorPointing();
                 return;
             }
-            updateEndOfFile();
+            if(descriptors[0].revents & POLLIN)
+            {
+                //Signal of stop is consumed, otherwise every following poll would return at once.
+                char signals[64];
+                while(read(wakeUp[0], signals, sizeof(signals)) > 0);
+            }
+            #if defined(__linux__)
+            if(notification != -1 and (descriptors[1].revents & POLLIN))
+            {
+                //Events only wake the follower, file itself tells what changed.
+                alignas(inotify_event) char events[4096];
+                while(read(notification, events, sizeof(events)) > 0);
+            }
+            #endif
         }
 
-        /**Function, which will attempt to move pointer to choosen place.
+    public:
+        ///Last error storage. Uneditable from outside.
+        const int &error = privateError;
+
+        ///Path of followed file.
+        const std::string &path = privatePath;
+
+        ///Amount of times file was replaced by new one.
+        const std::uint64_t &rotations = privateRotations;
+
+        ///Amount of times file was truncated.
+        const std::uint64_t &truncations = privateTruncations;
+
+        fileFollower() = default;
+
+        fileFollower(const fileFollower&) = delete;
+
+        /**Opens file for following.
         *Syntax is following:
-        *fileStreamName.pointTo(place in file, from where to start)
-        *We can start from the:
-        *1 - start;
-        *2 - current position;
-        *3 - end position.
-        *If your system supports so you can use:
-        *4 - SEEK_DATA;
-        *5 - SEEK_HOLE.
+        *followerName.open(path);
         */
-        void pointTo(int pointer, unsigned short from = 1, int errorCode = defaultErrorCode)
+        void open(const char* choosenPath, const fileFollowSettings& settings = fileFollowSettings(), int errorCode = fileStream<char>::defaultErrorCode)
         {
-            if(privateMode == 3 or !isStreamOpen())
+            if(stream.isStreamOpen() or choosenPath == nullptr or settings.bufferSize == 0)
             {
                 privateError = errorCode;
                 return;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            int errorCheck = 0;
-            switch(from)
+            stream.open(choosenPath, 1, true, errorCode);
+            if(stream.error != 0)
             {
-                default: privateError = errorCode; return;
-                case 1: errorCheck = fseek(file, pointer, SEEK_SET); break;
-                case 2: errorCheck = fseek(file, pointer, SEEK_CUR); break;
-                case 3: errorCheck = fseek(file, pointer, SEEK_END); break;
-                #ifdef _GNU_SOURCE
-                case 4: errorCheck = fseek(file, pointer, SEEK_DATA); break;
-                case 5: errorCheck = fseek(file, pointer, SEEK_HOLE); break;
-                #endif
+                privateError = stream.getError();
+                return;
             }
-
-            if(errorCheck != 0 or isError())
+            if(pipe(wakeUp) != 0)
             {
-                privateError = extractError();
-                clearErrorPointing();
+                privateError = (errno != 0)?(errno):(errorCode);
+                stream.close();
                 return;
             }
-            privateEndOfFile = false;
-            updateEndOfFile();
+            fcntl(wakeUp[0], F_SETFL, fcntl(wakeUp[0], F_GETFL) | O_NONBLOCK);
+            privatePath = choosenPath;
+            privateSettings = settings;
+            stopping = false;
+            pending.clear();
+            pendingPlace = 0;
+            offset = 0;
+            privateRotations = privateTruncations = 0;
+            struct stat status;
+            if(settings.fromEnd and fstat(fileno(stream.file), &status) == 0)
+            {
+                offset = status.st_size;
+            }
+            startNotification();
         }
 
-        ///Returns size of a file.
-        size_t size(int errorCode = defaultErrorCode)
+        /**Gives next complete line without '\n', waiting for it up to choosen amount of milliseconds, -1 waits without limit.
+        *Returns false if time passed, following was stopped, or error happened.
+        *Syntax is following:
+        *followerName.nextLine(line, timeout);
+        */
+        bool nextLine(std::string& line, int timeout = -1, int errorCode = fileStream<char>::defaultErrorCode)
         {
-            if(privateMode == 3 or !isStreamOpen())
+            if(!stream.isStreamOpen())
             {
                 privateError = errorCode;
-                return 0;
+                return false;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            size_t current = ftell(file);
-            fseek(file, 0, SEEK_END);
-            size_t returned = ftell(file);
-            fseek(file, current, SEEK_SET);
-            if(isError())
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds((timeout > 0)?(timeout):(0));
+            while(true)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return 0;
+                if(takeLine(line))
+                {
+                    return true;
+                }
+                long long appended = readAppended();
+                if(appended < 0)
+                {
+                    privateError = (errno != 0)?(errno):(errorCode);
+                    return false;
+                }
+                if(appended > 0)
+                {
+                    continue;
+                }
+                //Old file is read to its end here, so switching to new one loses nothing.
+                if(isRotated())
+                {
+                    bool lastLine = pendingPlace < pending.size();
+                    if(lastLine)
+                    {
+                        line.assign(pending, pendingPlace, std::string::npos);
+                    }
+                    pending.clear();
+                    pendingPlace = 0;
+                    offset = 0;
+                    stream.close();
+                    stream.open(privatePath.c_str(), 1, true, errorCode);
+                    if(stream.error != 0)
+                    {
+                        privateError = stream.getError();
+                        return false;
+                    }
+                    ++privateRotations;
+                    watchFile();
+                    if(lastLine)
+                    {
+                        return true;
+                    }
+                    continue;
+                }
+                if(isTruncated())
+                {
+                    continue;
+                }
+                int remaining = -1;
+                if(timeout >= 0)
+                {
+                    remaining = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+                }
+                if(stopping or (timeout >= 0 and remaining <= 0))
+                {
+                    return false;
+                }
+                wait(remaining);
             }
-            return returned;
         }
 
-        /**Function which reads in fprintf/fscanf format. Requires pointers to variables, not variables itself.
-        *You can specify type for format characters(char, char16_t, char32_t).
-        *Syntax is following:
-        *fileStreamName.getBtFormat<type>(format, pointers to all variables to which result will be written);
-        */
-        template<class char_type = char, class... Arguments>
-        int getByFormat(const char_type* const& format, Arguments*... arguments)
+        ///Wakes thread waiting in nextLine and makes following calls return false. Safe to call from other thread.
+        void stop()
         {
-            //if(!isValidForTextReading())
-            if(!isValidForReading())
-            {
-                privateError = defaultErrorCode;
-                return 0;
-            }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            //If format strings can be influenced by an attacker, they can be exploited (CWE-134). Use a constant for the format specification.
-            int processedInt = fscanf(file, format, arguments...);
-            if(isError())
+            stopping = true;
+            if(wakeUp[1] != -1)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return privateError;
+                char signal = 1;
+                while(write(wakeUp[1], &signal, 1) < 0 and errno == EINTR);
             }
-            updateEndOfFile();
-            if(processedInt < 0)
+        }
+
+        ///Closes followed file. Mustn't be called while other thread waits in nextLine, use stop first.
+        void close()
+        {
+            stream.close();
+            for(int* descriptor : {&notification, &wakeUp[0], &wakeUp[1]})
             {
-                privateError = (unsigned short)processedInt;
-                return 0;
+                if(*descriptor != -1)
+                {
+                    ::close(*descriptor);
+                    *descriptor = -1;
+                }
             }
-            else if(isError())
+            fileWatch = directoryWatch = -1;
+            pending.clear();
+            pendingPlace = 0;
+        }
+
+        ///Close follower automatically during destruction.
+        ~fileFollower()
+        {
+            close();
+        }
+};
+#endif
+
+/**
+ * Settings of external sorter.
+ */
+struct fileSortSettings
+{
+    ///Memory used for records, shared by all threads while runs are made and by all run buffers while they are merged.
+    size_t memoryBudget = 256 << 20;
+
+    ///Amount of threads making runs, 0 uses amount of hardware threads.
+    unsigned threads = 0;
+
+    ///Size of buffer of every run and of output while merging. Amount of runs merged at once is limited, so buffers keep this size within budget.
+    size_t bufferSize = 4 << 20;
+
+    ///Largest amount of runs merged at once, 0 chooses it from memory budget and limit of open files. More runs are merged in several passes.
+    size_t maxFanIn = 0;
+
+    ///Reads runs ahead in one background thread while merging.
+    bool prefetch = true;
+
+    ///Beginning of paths of temporary run files, path of output if empty.
+    std::string temporaryPath;
+};
+
+/**
+ * Counters of external sorter. Times are in nanoseconds.
+ */
+struct fileSortStatistics
+{
+    ///Amount of sorted records.
+    std::uint64_t records = 0;
+
+    ///Amount of sorted runs written into temporary files.
+    std::uint64_t runs = 0;
+
+    ///Time of making runs: reading, sorting and writing them.
+    std::uint64_t runPhase = 0;
+
+    ///Time spent sorting in memory, summed over all threads.
+    std::uint64_t sorting = 0;
+
+    ///Amount of merge passes, the last one writes output.
+    std::uint64_t passes = 0;
+
+    ///Time of merging runs into output.
+    std::uint64_t mergePhase = 0;
+};
+
+/**
+ * Sorter of binary files of records, written by writeBlock, which don't fit into memory.
+ * Input is split into runs fitting into memory budget, which are sorted by several threads and written into temporary files.
+ * Runs are merged into output with loser tree, which needs one comparison per tree level for each record.
+ * When there are more runs than can be merged at once, groups of them are merged into longer runs first.
+ * Syntax is following:
+ * fileSorter<type of record> sorterName(settings);
+ * sorterName.sort(inputPath, outputPath, comparator);
+ */
+template<class type>
+struct fileSorter
+{
+    static_assert(std::is_trivially_copyable<type>::value, "Records have to be trivially copyable.");
+
+    protected:
+        ///Sorted run stored in temporary file.
+        struct run
+        {
+            size_t index = 0;
+            std::uint64_t records = 0;
+        };
+
+        ///Run being merged. With prefetching, ahead buffer is filled in background while buffer is consumed.
+        struct source
+        {
+            fileStream<char> stream;
+            std::vector<type> buffer;
+            std::vector<type> ahead;
+            size_t place = 0;
+            size_t count = 0;
+            size_t aheadCount = 0;
+            std::uint64_t remaining = 0;
+            bool aheadReady = false;
+        };
+
+        ///State of merge pass shared with its prefetching thread.
+        struct prefetcher
+        {
+            std::mutex guard;
+            std::condition_variable changed;
+
+            ///Run, which merging waits for, so it is filled first.
+            size_t wanted = SIZE_MAX;
+
+            ///Run, from which search of run needing data continues.
+            size_t scanPlace = 0;
+
+            bool stopping = false;
+
+            int failure = 0;
+        };
+
+        fileSortSettings privateSettings;
+
+        fileSortStatistics privateStatistics;
+
+        ///Amount of records in every run except the last one.
+        std::uint64_t runRecords = 0;
+
+        ///Error storage.
+        int privateError = 0;
+
+    private:
+        static std::uint64_t since(std::chrono::steady_clock::time_point started)
+        {
+            return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count();
+        }
+
+        std::string runPath(const char* outputPath, size_t index) const
+        {
+            return ((privateSettings.temporaryPath.empty())?(std::string(outputPath)):(privateSettings.temporaryPath)) + ".run" + std::to_string(index);
+        }
+
+        ///Amount of runs merged at once.
+        size_t fanIn() const
+        {
+            size_t limit = privateSettings.maxFanIn;
+            if(limit == 0)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return privateError;
+                //Every run keeps full buffers, one more is used by output.
+                size_t bufferSize = (privateSettings.bufferSize > sizeof(type))?(privateSettings.bufferSize):(sizeof(type));
+                size_t buffers = privateSettings.memoryBudget / bufferSize;
+                limit = ((buffers > 1)?(buffers - 1):(0)) / ((privateSettings.prefetch)?(2):(1));
             }
-            else
+            #ifdef LIBFILESTREAM_POSIX
+            //Half of allowed descriptors is left to the rest of program.
+            rlimit files;
+            if(getrlimit(RLIMIT_NOFILE, &files) == 0 and files.rlim_cur != RLIM_INFINITY and files.rlim_cur / 2 < limit)
             {
-                return processedInt;
+                limit = (size_t)(files.rlim_cur / 2);
             }
+            #endif
+            return (limit >= 2)?(limit):(2);
         }
 
-        /**Function which writes in fprintf/fscanf format. Requires variables.
-        *You can specify type for format characters(char, char16_t, char32_t).
-        *Syntax is following:
-        *fileStreamName.writeByFormat<type>(format, pointers to all variables values of which will be written);
-        */
-        template<class char_type = char, class... Arguments>
-        int writeByFormat(const char_type* const& format, Arguments... arguments)
+        ///Reads next records of run into choosen buffer. Returns false on failure.
+        static bool readRecords(source& current, std::vector<type>& buffer, size_t& count)
         {
-            //if(!isValidForTextWriting())
-            if(!isValidForWriting())
+            count = (current.remaining < buffer.size())?((size_t)current.remaining):(buffer.size());
+            if(count != 0 and current.stream.readBlockInto(buffer.data(), count) != count)
             {
-                privateError = defaultErrorCode;
-                return 0;
+                count = 0;
+                return false;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            //If format strings can be influenced by an attacker, they can be exploited (CWE-134). Use a constant for the format specification.
-            int processedInt = fprintf(file, format, arguments...);
-            if(isError())
+            current.remaining -= count;
+            return true;
+        }
+
+        ///Fills ahead buffers of all runs of merge pass, run which merging waits for first. Single thread serves whole pass.
+        static void prefetchLoop(source* sources, size_t runs, prefetcher& shared, int errorCode)
+        {
+            std::unique_lock<std::mutex> lock(shared.guard);
+            while(true)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return privateError;
+                size_t chosen = runs;
+                shared.changed.wait(lock, [&]()
+                {
+                    if(shared.stopping)
+                    {
+                        return true;
+                    }
+                    if(shared.wanted < runs and !sources[shared.wanted].aheadReady)
+                    {
+                        chosen = shared.wanted;
+                        return true;
+                    }
+                    for(size_t i = 0; i < runs; ++i)
+                    {
+                        size_t candidate = (shared.scanPlace + i) % runs;
+                        //Only this thread changes remaining records, so they are read safely.
+                        if(!sources[candidate].aheadReady and sources[candidate].remaining != 0)
+                        {
+                            chosen = candidate;
+                            return true;
+                        }
+                    }
+                    return false;
+                });
+                if(shared.stopping)
+                {
+                    return;
+                }
+                shared.scanPlace = chosen + 1;
+                lock.unlock();
+                source& current = sources[chosen];
+                size_t count = 0;
+                bool succeeded = readRecords(current, current.ahead, count);
+                int readError = (current.stream.error != 0)?(current.stream.error):(errorCode);
+                lock.lock();
+                current.aheadCount = count;
+                current.aheadReady = true;
+                if(!succeeded)
+                {
+                    shared.failure = readError;
+                }
+                shared.changed.notify_all();
             }
-            updateEndOfFile();
-            if(processedInt < 0)
+        }
+
+        ///Moves next records of run into its buffer. Returns false on failure.
+        static bool refill(source& current, size_t index, prefetcher* shared, int& failure)
+        {
+            current.place = 0;
+            if(shared == nullptr)
             {
-                privateError = (unsigned int)processedInt;
-                return 0;
+                bool succeeded = readRecords(current, current.buffer, current.count);
+                failure = (succeeded)?(0):(current.stream.error);
+                return succeeded;
             }
-            else if(isError())
+            std::unique_lock<std::mutex> lock(shared->guard);
+            shared->wanted = index;
+            shared->changed.notify_all();
+            shared->changed.wait(lock, [&]()
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return privateError;
-            }
-            else
+                return current.aheadReady or shared->failure != 0;
+            });
+            shared->wanted = SIZE_MAX;
+            if(shared->failure != 0)
             {
-                return processedInt;
+                current.count = 0;
+                failure = shared->failure;
+                return false;
             }
+            current.buffer.swap(current.ahead);
+            current.count = current.aheadCount;
+            current.aheadReady = false;
+            shared->changed.notify_all();
+            return true;
         }
 
-        /**Function which reads in binary. Enforces for the type to be trivially copyable.
-        *Syntax is following:
-        *fileStreamName.readBlock<type of read value>(number of elements);
-        */
-        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
-        type* readBlock(const size_t &count, size_t errorCode = defaultErrorCode)
+        ///Splits input into sorted runs. Returns amount of runs or sets error.
+        template<class compare_type>
+        size_t makeRuns(const char* inputPath, const char* outputPath, compare_type& compare, int errorCode)
         {
-            if(count == 0)
+            fileStream<char> input(inputPath, 1, true, errorCode);
+            if(input.error != 0)
             {
-                privateError = ENOTSUP; //How I should allocate zero size array?
-                return nullptr;
+                privateError = input.getError();
+                return 0;
             }
-            if(!isValidForBinaryReading())
+            std::uint64_t bytes = input.size();
+            if(bytes % sizeof(type) != 0)
+            {
+                privateError = errorCode; //File doesn't consist of whole records.
+                return 0;
+            }
+            privateStatistics.records = bytes / sizeof(type);
+            unsigned workers = (privateSettings.threads != 0)?(privateSettings.threads):(std::thread::hardware_concurrency());
+            workers = (workers != 0)?(workers):(1);
+            std::uint64_t chunk = privateSettings.memoryBudget / sizeof(type) / workers;
+            if(chunk == 0)
             {
                 privateError = errorCode;
-                return nullptr;
+                return 0;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            type* pointer = new type[count];
-            size_t result = fread(pointer, sizeof(type), count, file);
-            if(isError())
+            runRecords = chunk;
+            size_t runs = (size_t)((privateStatistics.records + chunk - 1) / chunk);
+            workers = (runs < workers)?((unsigned)runs):(workers);
+            std::mutex inputGuard;
+            size_t nextRun = 0;
+            std::atomic<int> failure{0};
+            std::atomic<std::uint64_t> sorting{0};
+            auto work = [&]()
             {
-                privateError = extractError();
-                clearErrorPointing();
-                delete[] pointer;
-                return nullptr;
+                std::vector<type> records;
+                while(failure == 0)
+                {
+                    size_t run = 0;
+                    size_t count = 0;
+                    {
+                        //Input is read by one thread at a time, so it is read sequentially.
+                        std::lock_guard<std::mutex> lock(inputGuard);
+                        if(nextRun == runs)
+                        {
+                            return;
+                        }
+                        run = nextRun++;
+                        count = (size_t)((privateStatistics.records - run * chunk < chunk)?(privateStatistics.records - run * chunk):(chunk));
+                        records.resize(count);
+                        if(input.readBlockInto(records.data(), count) != count)
+                        {
+                            failure = (input.error != 0)?(input.getError()):(errorCode);
+                            return;
+                        }
+                    }
+                    auto started = std::chrono::steady_clock::now();
+                    std::sort(records.begin(), records.end(), compare);
+                    sorting += since(started);
+                    fileStream<char> output(runPath(outputPath, run).c_str(), 2, true, errorCode);
+                    output.writeBlock(records.data(), count, errorCode);
+                    output.flush(errorCode);
+                    if(output.error != 0)
+                    {
+                        failure = output.getError();
+                        return;
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            for(unsigned i = 1; i < workers; ++i)
+            {
+                threads.emplace_back(work);
             }
-            updateEndOfFile();
-            if(result == 0 or isError())
+            work();
+            for(std::thread& thread : threads)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                delete[] pointer;
-                return nullptr;
+                thread.join();
             }
-            return pointer;
+            privateStatistics.sorting = sorting;
+            if(failure != 0)
+            {
+                privateError = failure;
+                for(size_t run = 0; run < nextRun; ++run)
+                {
+                    remove(runPath(outputPath, run).c_str());
+                }
+                return 0;
+            }
+            return runs;
         }
 
-        /**Function which reads in binary. Enforces for the type to be trivially copyable.
-        *Syntax is following:
-        *fileStreamName.readVariable<type of read value>();
-        */
-        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
-        type readVariable(size_t errorCode = defaultErrorCode)
+        ///Merges group of sorted runs into file at target path. Run files are removed, target is removed on failure.
+        template<class compare_type>
+        bool mergeRuns(const run* runs, size_t count, const char* outputPath, const std::string& targetPath, compare_type& compare, int errorCode)
         {
-            if(!isValidForBinaryReading())
+            //Every run has its buffer, prefetching needs one more for every run, and output has one.
+            size_t buffers = (privateSettings.prefetch)?(count * 2 + 1):(count + 1);
+            size_t bufferSize = (privateSettings.bufferSize * buffers > privateSettings.memoryBudget)?(privateSettings.memoryBudget / buffers):(privateSettings.bufferSize);
+            size_t bufferRecords = (bufferSize / sizeof(type) != 0)?(bufferSize / sizeof(type)):(1);
+            std::unique_ptr<source[]> sources(new source[count]);
+            std::uint64_t records = 0;
+            bool succeeded = true;
+            for(size_t place = 0; place < count and succeeded; ++place)
             {
-                privateError = errorCode;
-                return {};
+                source& current = sources[place];
+                current.stream.open(runPath(outputPath, runs[place].index).c_str(), 1, true, errorCode);
+                privateError = current.stream.error;
+                current.remaining = runs[place].records;
+                current.buffer.resize(bufferRecords);
+                current.ahead.resize((privateSettings.prefetch)?(bufferRecords):(0));
+                records += runs[place].records;
+                succeeded = privateError == 0;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            type variable;
-            size_t result = fread(&variable, sizeof(type), 1, file);
-            if(isError())
+            prefetcher shared;
+            prefetcher* prefetching = (privateSettings.prefetch and succeeded)?(&shared):(nullptr);
+            std::thread background;
+            if(prefetching != nullptr)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return {};
+                background = std::thread(&fileSorter::prefetchLoop, sources.get(), count, std::ref(shared), errorCode);
             }
-            updateEndOfFile();
-            if(result == 0 or isError())
+            int failure = 0;
+            for(size_t place = 0; place < count and succeeded; ++place)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return {};
+                succeeded = refill(sources[place], place, prefetching, failure);
             }
-            return variable;
-        }
-
-        /**Function which writes in binary. Enforces for the type to be trivially copyable.
-        *Syntax is following:
-        *fileStreamName.writeBlock<type of written value, unnecessary>(pointer to written element, number of elements);
-        */
-        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
-        void writeBlock(type* pointer, size_t count, size_t errorCode = defaultErrorCode)
-        {
-            if(!isValidForBinaryWriting())
+            fileAllocation allocation;
+            allocation.expectedSize = records * sizeof(type);
+            fileStream<char> output;
+            if(succeeded)
             {
-                privateError = errorCode;
-                return;
+                output.open(targetPath.c_str(), 2, true, allocation, errorCode);
+                succeeded = output.error == 0;
+                failure = output.getError();
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            size_t result = fwrite(pointer, sizeof(type), count, file);
-            if(isError())
+            if(succeeded)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return;
+                //Exhausted run is bigger than any record.
+                auto isLess = [&](size_t first, size_t second) -> bool
+                {
+                    if(sources[first].place == sources[first].count)
+                    {
+                        return false;
+                    }
+                    if(sources[second].place == sources[second].count)
+                    {
+                        return true;
+                    }
+                    return compare(sources[first].buffer[sources[first].place], sources[second].buffer[sources[second].place]);
+                };
+                //Leaves are at places from count to 2 * count - 1, every inner node keeps loser of its match and tree[0] keeps overall winner.
+                std::vector<size_t> tree(count);
+                std::vector<size_t> winners(count * 2);
+                for(size_t place = 0; place < count; ++place)
+                {
+                    winners[count + place] = place;
+                }
+                for(size_t node = count - 1; node >= 1; --node)
+                {
+                    size_t left = winners[node * 2], right = winners[node * 2 + 1];
+                    bool rightWins = isLess(right, left);
+                    winners[node] = (rightWins)?(right):(left);
+                    tree[node] = (rightWins)?(left):(right);
+                }
+                tree[0] = winners[1];
+                std::vector<type> merged;
+                merged.reserve(bufferRecords);
+                while(sources[tree[0]].place != sources[tree[0]].count)
+                {
+                    size_t winner = tree[0];
+                    source& current = sources[winner];
+                    merged.push_back(current.buffer[current.place++]);
+                    if(merged.size() == bufferRecords)
+                    {
+                        output.writeBlock(merged.data(), merged.size(), errorCode);
+                        merged.clear();
+                    }
+                    if(current.place == current.count and !refill(current, winner, prefetching, failure))
+                    {
+                        succeeded = false;
+                        break;
+                    }
+                    //Winner meets losers on the way to the root.
+                    for(size_t node = (winner + count) / 2; node >= 1; node /= 2)
+                    {
+                        if(isLess(tree[node], winner))
+                        {
+                            std::swap(tree[node], winner);
+                        }
+                    }
+                    tree[0] = winner;
+                }
+                if(succeeded)
+                {
+                    if(!merged.empty())
+                    {
+                        output.writeBlock(merged.data(), merged.size(), errorCode);
+                    }
+                    output.flush(errorCode);
+                    succeeded = output.error == 0;
+                    failure = output.getError();
+                }
+                output.close();
             }
-            if(result == 0 or result != count)
+            if(background.joinable())
             {
-                privateError = errorCode;
-                return;
+                {
+                    std::lock_guard<std::mutex> lock(shared.guard);
+                    shared.stopping = true;
+                    shared.changed.notify_all();
+                }
+                background.join();
             }
-            if(isError())
+            for(size_t place = 0; place < count; ++place)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return;
+                sources[place].stream.close();
+                remove(runPath(outputPath, runs[place].index).c_str());
             }
-            updateEndOfFile();
+            if(!succeeded)
+            {
+                privateError = (privateError != 0)?(privateError):((failure != 0)?(failure):(errorCode));
+                remove(targetPath.c_str());
+            }
+            return succeeded;
         }
 
-        /**Function which writes in binary. Enforces for the type to be trivially copyable.
+    public:
+        ///Last error storage. Uneditable from outside.
+        const int &error = privateError;
+
+        fileSorter() = default;
+
+        fileSorter(const fileSortSettings& settings) : privateSettings(settings) {}
+
+        fileSorter(const fileSorter&) = delete;
+
+        /**Sorts records of input file into output file in order of comparator, which tells whenever first record goes before second one.
+        *Output mustn't be the same file as input.
         *Syntax is following:
-        *fileStreamName.writeVariable<type of written value, unnecessary>(written element);
+        *sorterName.sort(inputPath, outputPath, comparator);
         */
-        template<class type, typename = typename std::enable_if<std::is_trivially_copyable<type>::value>>
-        void writeVariable(const type &variable, size_t errorCode = defaultErrorCode)
+        template<class compare_type = std::less<type>>
+        void sort(const char* inputPath, const char* outputPath, compare_type compare = compare_type(), int errorCode = fileStream<char>::defaultErrorCode)
         {
-            if(!isValidForBinaryWriting())
+            if(inputPath == nullptr or outputPath == nullptr)
             {
                 privateError = errorCode;
                 return;
             }
-            clearErrorPointing(); //Ensure that only own reports will be reported.
-            size_t result = fwrite(&variable, sizeof(type), 1, file);
-            if(isError())
+            privateError = 0;
+            privateStatistics = fileSortStatistics();
+            auto started = std::chrono::steady_clock::now();
+            size_t runs = makeRuns(inputPath, outputPath, compare, errorCode);
+            privateStatistics.runs = runs;
+            privateStatistics.runPhase = since(started);
+            if(privateError != 0)
             {
-                privateError = extractError();
-                clearErrorPointing();
                 return;
             }
-            if(result != 1)
+            started = std::chrono::steady_clock::now();
+            if(runs == 0)
             {
-                privateError = errorCode;
+                fileStream<char> output(outputPath, 2, true, errorCode);
+                privateError = output.getError();
+                privateStatistics.mergePhase = since(started);
                 return;
             }
-            if(isError())
+            std::vector<run> pending(runs);
+            for(size_t index = 0; index < runs; ++index)
             {
-                privateError = extractError();
-                clearErrorPointing();
-                return;
+                pending[index].index = index;
+                pending[index].records = (privateStatistics.records - index * runRecords < runRecords)?(privateStatistics.records - index * runRecords):(runRecords);
             }
-            updateEndOfFile();
-        }
-
-        ///Compare two file streams.
-        inline bool operator==(const fileStream& file) const
-        {
-            return (isStringsEqual(file.path, path) and (file.mode == mode) and (file.binary == binary));
-        }
-
-        ///Opens new file stream with the same parameters as old.
-        template<class type>
-        fileStream<type>& operator=(const fileStream<type>& file)
-        {
-            close();
-            if(file.path != nullptr and file.mode != 0)
+            size_t width = fanIn();
+            size_t nextIndex = runs;
+            //Groups are merged into longer runs until all of them can be merged at once.
+            while(pending.size() > width and privateError == 0)
             {
-                open(file.path, file.mode, file.binary);
+                std::vector<run> merged;
+                for(size_t first = 0; first < pending.size(); first += width)
+                {
+                    size_t count = (pending.size() - first < width)?(pending.size() - first):(width);
+                    if(count == 1 or privateError != 0)
+                    {
+                        //Runs are kept, so they are removed after failure.
+                        merged.insert(merged.end(), pending.begin() + first, pending.begin() + first + count);
+                        continue;
+                    }
+                    run longer;
+                    longer.index = nextIndex++;
+                    for(size_t place = first; place < first + count; ++place)
+                    {
+                        longer.records += pending[place].records;
+                    }
+                    if(mergeRuns(&pending[first], count, outputPath, runPath(outputPath, longer.index), compare, errorCode))
+                    {
+                        merged.push_back(longer);
+                    }
+                }
+                pending.swap(merged);
+                ++privateStatistics.passes;
             }
-            return *this;
-        }
-
-        template<typename type, typename = typename std::enable_if<std::is_trivial<type>::value && !std::is_same<type, std::string>::value>>
-        fileStream& operator<<(const type& written)
-        {
-            writeVariable(written);
-            return *this;
-        }
-
-        template<typename type, typename = typename std::enable_if<std::is_trivial<type>::value && !std::is_same<type, std::string>::value>>
-        fileStream& operator>>(type& read)
-        {
-            if(!isValidForBinaryReading())
+            if(privateError != 0)
             {
-                privateError = defaultErrorCode;
-                read = {};
-                return *this;
+                for(const run& current : pending)
+                {
+                    remove(runPath(outputPath, current.index).c_str());
+                }
             }
-            read = readVariable<type>();
-            return *this;
-        }
-
-        // fileStream& operator>>(std::string& read)
-        // {
-            
-        // }
-
-        template<typename type>
-        fileStream& operator<<(const type* const& written)
-        {
-            writeString(written);
-            return *this;
+            else if(pending.size() > 1 or std::rename(runPath(outputPath, pending[0].index).c_str(), outputPath) != 0)
+            {
+                //Single run is already the output, unless it can't be moved there.
+                mergeRuns(pending.data(), pending.size(), outputPath, outputPath, compare, errorCode);
+                ++privateStatistics.passes;
+            }
+            privateStatistics.mergePhase = since(started);
         }
 
-        // template<>
-        fileStream& operator<<(const std::string& written)
+        /**Sorts records of input file into output file in ascending order of keys, which key function gives for records.
+        *Syntax is following:
+        *sorterName.sortByKey(inputPath, outputPath, [](const type& record){ return record.key; });
+        */
+        template<class key_type>
+        void sortByKey(const char* inputPath, const char* outputPath, key_type key, int errorCode = fileStream<char>::defaultErrorCode)
         {
-            writeString(written.c_str());
-            return *this;
+            sort(inputPath, outputPath, [&key](const type& first, const type& second)
+            {
+                return key(first) < key(second);
+            }, errorCode);
         }
 
-        // template<>
-        fileStream& operator>>(std::string& read)
+        ///Returns counters of last sorting.
+        fileSortStatistics statistics() const
         {
-            if(!isValidForReading())
-            {
-                return *this;
-            }
-            // const char divisionChars[] = "\n \t";
-            read.clear();
-            // char read = '\0';
-            // while(!end && !(read == '\n' || read == ' ' || read == '\t'))
-            // {
-            //     read = getCharacter();
-            //     written.push_back(read);
-            // }
-            for(char current = '\0'; !(current == '\n' || current == ' ' || current == '\t'); read = getCharacter()) read.push_back(current);
-            return *this;
+            return privateStatistics;
         }
 };